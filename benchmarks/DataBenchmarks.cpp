@@ -0,0 +1,53 @@
+#include <panda/data/DataCopier.h>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using panda::AbstractDataCopier;
+using panda::Data;
+using panda::DataCopiersList;
+
+namespace
+{
+
+// Copy a list of N values of type From to a Data of lists of To, the way it is done when linking both Datas
+// When the types are the same, the value is shared instead of being copied
+template <class From, class To>
+void BM_DataCopier_Copy(benchmark::State& state)
+{
+	const int nb = static_cast<int>(state.range(0));
+	Data<std::vector<From>> from("from", "", nullptr);
+	Data<std::vector<To>> dest("dest", "", nullptr);
+
+	{
+		auto acc = from.getAccessor();
+		acc.resize(nb);
+		for (int i = 0; i < nb; ++i)
+			acc[i] = static_cast<From>(i);
+	}
+
+	AbstractDataCopier* copier = DataCopiersList::getCopierOf<std::vector<To>>();
+	if (!copier)
+	{
+		state.SkipWithError("No copier for the destination type");
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		if (!copier->copyData(&dest, &from))
+		{
+			state.SkipWithError("Could not copy the value");
+			break;
+		}
+		benchmark::DoNotOptimize(dest.getValue().data());
+	}
+	state.SetComplexityN(nb);
+	state.SetItemsProcessed(state.iterations() * nb);
+}
+BENCHMARK_TEMPLATE(BM_DataCopier_Copy, float, float)->RangeMultiplier(8)->Range(8, 1 << 20)->Complexity();
+BENCHMARK_TEMPLATE(BM_DataCopier_Copy, int, float)->RangeMultiplier(8)->Range(8, 1 << 20)->Complexity();
+BENCHMARK_TEMPLATE(BM_DataCopier_Copy, float, int)->RangeMultiplier(8)->Range(8, 1 << 20)->Complexity();
+
+} // namespace
@@ -0,0 +1,114 @@
+#include <panda/helper/Perlin.h>
+#include <panda/helper/PointsGrid.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using panda::helper::Perlin;
+using panda::helper::PointsGrid;
+using panda::types::Point;
+using panda::types::Rect;
+
+namespace
+{
+
+const float areaSize = 1000;
+const int nbQueries = 1024; // The query points are taken in a list, in a random order
+
+std::vector<Point> randomPoints(int nb, unsigned int seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_real_distribution<float> dist(0, areaSize);
+	std::vector<Point> points(nb);
+	for (auto& pt : points)
+		pt = Point(dist(gen), dist(gen));
+	return points;
+}
+
+// PointsGrid, the number of points in the grid is the parameter
+// The cell size is fixed, so the density of the points (and the cost of a query) increases with their number
+
+void BM_PointsGrid_Build(benchmark::State& state)
+{
+	const auto points = randomPoints(static_cast<int>(state.range(0)), 42);
+	PointsGrid grid;
+	for (auto _ : state)
+	{
+		grid.initGrid(Rect(0, 0, areaSize, areaSize), 10);
+		grid.addPoints(points);
+		benchmark::ClobberMemory();
+	}
+	state.SetComplexityN(state.range(0));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PointsGrid_Build)->RangeMultiplier(4)->Range(64, 1 << 16)->Complexity();
+
+void BM_PointsGrid_GetNearest(benchmark::State& state)
+{
+	PointsGrid grid;
+	grid.initGrid(Rect(0, 0, areaSize, areaSize), 10);
+	grid.addPoints(randomPoints(static_cast<int>(state.range(0)), 42));
+
+	const auto queries = randomPoints(nbQueries, 1);
+	Point result;
+	int i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(grid.getNearest(queries[i], 20, result));
+		i = (i + 1) % nbQueries;
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_PointsGrid_GetNearest)->RangeMultiplier(4)->Range(64, 1 << 16)->Complexity();
+
+void BM_PointsGrid_TestNeighbor(benchmark::State& state)
+{
+	PointsGrid grid;
+	grid.initGrid(Rect(0, 0, areaSize, areaSize), 10);
+	grid.addPoints(randomPoints(static_cast<int>(state.range(0)), 42));
+
+	const auto queries = randomPoints(nbQueries, 1);
+	int i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(grid.testNeighbor(queries[i], 10));
+		i = (i + 1) % nbQueries;
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_PointsGrid_TestNeighbor)->RangeMultiplier(4)->Range(64, 1 << 16)->Complexity();
+
+// Perlin noise, the number of octaves is the parameter
+
+void BM_Perlin_fBm2D(benchmark::State& state)
+{
+	const Perlin perlin(static_cast<uint8_t>(state.range(0)), 42);
+	const auto queries = randomPoints(nbQueries, 1);
+	int i = 0;
+	for (auto _ : state)
+	{
+		const auto& pt = queries[i];
+		benchmark::DoNotOptimize(perlin.fBm(pt.x / 100, pt.y / 100));
+		i = (i + 1) % nbQueries;
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_Perlin_fBm2D)->DenseRange(1, 8)->Complexity(benchmark::oN);
+
+void BM_Perlin_fBm3D(benchmark::State& state)
+{
+	const Perlin perlin(static_cast<uint8_t>(state.range(0)), 42);
+	const auto queries = randomPoints(nbQueries, 1);
+	int i = 0;
+	for (auto _ : state)
+	{
+		const auto& pt = queries[i];
+		benchmark::DoNotOptimize(perlin.fBm(pt.x / 100, pt.y / 100, static_cast<float>(i) / nbQueries));
+		i = (i + 1) % nbQueries;
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_Perlin_fBm3D)->DenseRange(1, 8)->Complexity(benchmark::oN);
+
+} // namespace
@@ -0,0 +1,84 @@
+#include <panda/types/Mesh.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+
+using panda::types::Mesh;
+using panda::types::Point;
+
+namespace
+{
+
+// Regular grid of side x side points, each cell cut in 2 triangles
+Mesh createGridMesh(int side)
+{
+	Mesh mesh;
+	for (int y = 0; y < side; ++y)
+		for (int x = 0; x < side; ++x)
+			mesh.addPoint(Point(static_cast<float>(x), static_cast<float>(y)));
+
+	for (int y = 0; y + 1 < side; ++y)
+	{
+		for (int x = 0; x + 1 < side; ++x)
+		{
+			const Mesh::PointID p = y * side + x;
+			mesh.addTriangle(p, p + 1, p + side);
+			mesh.addTriangle(p + 1, p + side + 1, p + side);
+		}
+	}
+
+	return mesh;
+}
+
+void BM_Mesh_CreateEdgeList(benchmark::State& state)
+{
+	Mesh mesh = createGridMesh(static_cast<int>(state.range(0)));
+	for (auto _ : state)
+	{
+		mesh.clearEdges();
+		mesh.createEdgeList();
+		benchmark::DoNotOptimize(mesh.getEdges().data());
+	}
+	state.SetComplexityN(mesh.nbTriangles());
+}
+BENCHMARK(BM_Mesh_CreateEdgeList)->RangeMultiplier(2)->Range(8, 256)->Complexity();
+
+void BM_Mesh_CreateTrianglesAroundEdgeList(benchmark::State& state)
+{
+	Mesh mesh = createGridMesh(static_cast<int>(state.range(0)));
+	mesh.createEdgeList();
+	mesh.createEdgesInTriangleList();
+	for (auto _ : state)
+	{
+		mesh.clearTrianglesAroundEdge();
+		mesh.createTrianglesAroundEdgeList();
+		benchmark::DoNotOptimize(mesh.getTrianglesAroundEdgeList().data());
+	}
+	state.SetComplexityN(mesh.nbTriangles());
+}
+BENCHMARK(BM_Mesh_CreateTrianglesAroundEdgeList)->RangeMultiplier(2)->Range(8, 256)->Complexity();
+
+void BM_Mesh_GetEdgeIndex(benchmark::State& state)
+{
+	Mesh mesh = createGridMesh(static_cast<int>(state.range(0)));
+	mesh.createEdgeList();
+
+	// Search the edges in a random order, so that the position in the list is not always the same
+	std::vector<Mesh::Edge> edges = mesh.getEdges();
+	std::shuffle(edges.begin(), edges.end(), std::mt19937(42));
+
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		const auto& e = edges[i];
+		benchmark::DoNotOptimize(mesh.getEdgeIndex(e[0], e[1]));
+		if (++i == edges.size())
+			i = 0;
+	}
+	state.SetComplexityN(mesh.nbEdges());
+}
+BENCHMARK(BM_Mesh_GetEdgeIndex)->RangeMultiplier(2)->Range(8, 128)->Complexity();
+
+} // namespace
@@ -0,0 +1,140 @@
+#include <panda/types/Animation.h>
+#include <panda/types/Gradient.h>
+#include <panda/types/Path.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using panda::types::Animation;
+using panda::types::Color;
+using panda::types::Gradient;
+using panda::types::Path;
+using panda::types::Point;
+
+namespace
+{
+
+const int nbPositions = 1024; // The positions given to get are taken in a list, in a random order
+
+std::vector<float> randomPositions(float min, float max)
+{
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<float> dist(min, max);
+	std::vector<float> positions(nbPositions);
+	for (auto& p : positions)
+		p = dist(gen);
+	return positions;
+}
+
+Path randomPath(int nbPoints)
+{
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<float> dist(0, 1000);
+	Path path;
+	path.points.resize(nbPoints);
+	for (auto& pt : path.points)
+		pt = Point(dist(gen), dist(gen));
+	return path;
+}
+
+// Gradient and Animation, the number of stops is the parameter
+
+void BM_Gradient_Get(benchmark::State& state)
+{
+	const int nbStops = static_cast<int>(state.range(0));
+	Gradient gradient;
+	for (int i = 0; i < nbStops; ++i)
+	{
+		const float pos = static_cast<float>(i) / (nbStops - 1);
+		gradient.add(pos, Color(pos, 1 - pos, 0.5f));
+	}
+
+	const auto positions = randomPositions(0, 1);
+	int i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(gradient.get(positions[i]));
+		i = (i + 1) % nbPositions;
+	}
+	state.SetComplexityN(nbStops);
+}
+BENCHMARK(BM_Gradient_Get)->RangeMultiplier(4)->Range(2, 2048)->Complexity();
+
+void BM_Animation_Get(benchmark::State& state)
+{
+	const int nbStops = static_cast<int>(state.range(0));
+	Animation<float> animation;
+	for (int i = 0; i < nbStops; ++i)
+		animation.add(static_cast<float>(i), static_cast<float>(i * i));
+
+	const auto positions = randomPositions(0, static_cast<float>(nbStops - 1));
+	int i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(animation.get(positions[i]));
+		i = (i + 1) % nbPositions;
+	}
+	state.SetComplexityN(nbStops);
+}
+BENCHMARK(BM_Animation_Get)->RangeMultiplier(4)->Range(2, 2048)->Complexity();
+
+// Path transforms, the number of points is the parameter
+
+void BM_Path_Translate(benchmark::State& state)
+{
+	Path path = randomPath(static_cast<int>(state.range(0)));
+	const Point delta(1, -1);
+	for (auto _ : state)
+	{
+		path += delta;
+		benchmark::ClobberMemory();
+		path -= delta;
+		benchmark::ClobberMemory();
+	}
+	state.SetComplexityN(state.range(0));
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_Path_Translate)->RangeMultiplier(8)->Range(8, 1 << 18)->Complexity();
+
+void BM_Path_Scale(benchmark::State& state)
+{
+	Path path = randomPath(static_cast<int>(state.range(0)));
+	for (auto _ : state)
+	{
+		path *= 2.f;
+		benchmark::ClobberMemory();
+		path /= 2.f;
+		benchmark::ClobberMemory();
+	}
+	state.SetComplexityN(state.range(0));
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_Path_Scale)->RangeMultiplier(8)->Range(8, 1 << 18)->Complexity();
+
+void BM_Path_Rotate(benchmark::State& state)
+{
+	Path path = randomPath(static_cast<int>(state.range(0)));
+	const Point center(500, 500);
+	for (auto _ : state)
+	{
+		rotate(path, center, 0.1f);
+		benchmark::ClobberMemory();
+	}
+	state.SetComplexityN(state.range(0));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Path_Rotate)->RangeMultiplier(8)->Range(8, 1 << 18)->Complexity();
+
+void BM_Path_Rotated(benchmark::State& state)
+{
+	const Path path = randomPath(static_cast<int>(state.range(0)));
+	const Point center(500, 500);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(rotated(path, center, 0.1f));
+	state.SetComplexityN(state.range(0));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Path_Rotated)->RangeMultiplier(8)->Range(8, 1 << 18)->Complexity();
+
+} // namespace
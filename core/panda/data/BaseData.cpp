@@ -1,5 +1,6 @@
 #include <panda/data/BaseData.h>
 #include <panda/data/DataCopier.h>
+#include <panda/document/PandaDocument.h>
 #include <panda/object/PandaObject.h>
 #include <panda/types/DataTraits.h>
 #include <panda/types/TypeConverter.h>
@@ -9,14 +10,26 @@
 #include <iostream>
 #include <typeindex>
 
+namespace
+{
+
+panda::helper::StringId defaultWidgetId()
+{
+	static const auto id = panda::helper::internString("default");
+	return id;
+}
+
+}
+
 namespace panda
 {
 
 BaseData::BaseData(const BaseInitData& init, const std::type_info& type)
-	: m_name(init.name)
-	, m_help(init.help)
-	, m_widget("default")
+	: DataNode(NodeKind::Data)
 	, m_owner(init.owner)
+	, m_name(helper::internString(init.name))
+	, m_help(helper::internString(init.help))
+	, m_widget(defaultWidgetId())
 {
 	initInternals(type);
 
@@ -25,10 +38,11 @@ BaseData::BaseData(const BaseInitData& init, const std::type_info& type)
 }
 
 BaseData::BaseData(const std::string& name, const std::string& help, PandaObject* owner, const std::type_info& type)
-	: m_name(name)
-	, m_help(help)
-	, m_widget("default")
+	: DataNode(NodeKind::Data)
 	, m_owner(owner)
+	, m_name(helper::internString(name))
+	, m_help(helper::internString(help))
+	, m_widget(defaultWidgetId())
 {
 	initInternals(type);
 
@@ -36,6 +50,12 @@ BaseData::BaseData(const std::string& name, const std::string& help, PandaObject
 		m_owner->addData(this);
 }
 
+BaseData::~BaseData()
+{
+	if(m_owner && m_owner->parentDocument())
+		m_owner->parentDocument()->releaseNodeId(*this);
+}
+
 bool BaseData::validParent(const BaseData* parent) const
 {
 	auto trait = getDataTrait();
@@ -80,6 +100,9 @@ void BaseData::setParent(BaseData* parent)
 		m_parentBaseData = nullptr;
 
 	setFlag(DataOption::SetParentProtection, false);
+
+	if(m_owner && m_owner->parentDocument())
+		m_owner->parentDocument()->onChangedLink(this);
 }
 
 std::string BaseData::getDescription() const
@@ -94,6 +117,56 @@ void BaseData::copyValueFrom(const BaseData* from)
 		forceSet();
 }
 
+void BaseData::freeze()
+{
+	if(!m_parentBaseData)
+		return;
+
+	m_frozenCounter = m_parentBaseData->getCounter();
+	setFlag(DataOption::Frozen, true);
+}
+
+bool BaseData::unfreeze()
+{
+	if(!isFrozen())
+		return false;
+	setFlag(DataOption::Frozen, false);
+
+	if(!m_parentBaseData || m_parentBaseData->getCounter() == m_frozenCounter)
+		return false;
+
+	cleanDirty(); // Make sure the modification is propagated
+	setDirtyValue(m_parentBaseData);
+	return true;
+}
+
+bool BaseData::canTakeParentValue() const
+{
+	if(!m_parentBaseData || isFrozen() || m_parentBaseData->isFrozen() || !m_owner)
+		return false;
+
+	// If another Data or object uses the value of the parent, it must stay valid
+	const auto& parentOutputs = m_parentBaseData->getOutputs();
+	if(parentOutputs.size() != 1 || parentOutputs.front() != this)
+		return false;
+
+	auto document = m_owner->parentDocument();
+	return document && document->canTakeValue(m_parentBaseData);
+}
+
+void BaseData::valueTaken()
+{
+	// Not propagating: the only consumer already has the value, the owner will be updated again at the next step (the Scheduler propagates it when the animation stops)
+	doSetDirty();
+	if(m_owner)
+		m_owner->doSetDirty();
+}
+
+std::size_t BaseData::valueHeapSize(const void* value) const
+{
+	return getDataTrait()->heapSize(value);
+}
+
 void BaseData::save(XmlElement& elem) const
 {
 	getDataTrait()->writeValue(elem, getVoidValue());
@@ -149,6 +222,8 @@ void BaseData::initInternals(const std::type_info& type)
 {
 	m_dataTrait = types::DataTraitsList::getTrait(type);
 	m_dataCopier = DataCopiersList::getCopier(type);
+	if(m_dataTrait)
+		m_typeId = m_dataTrait->fullTypeId();
 
 	setFlag(DataOption::Displayed, getDataTrait()->isDisplayed());
 	setFlag(DataOption::Persistent, getDataTrait()->isPersistent());
@@ -156,7 +231,7 @@ void BaseData::initInternals(const std::type_info& type)
 
 void BaseData::setDirtyValue(const DataNode* caller)
 {
-	if(!isDirty())
+	if(!isDirty() && !isFrozen()) // A frozen data will check if its parent was modified when unfrozen
 	{
 		helper::ScopedEvent log(helper::event_setDirty, this);
 		DataNode::setDirtyValue(caller);
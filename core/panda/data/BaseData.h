@@ -3,6 +3,7 @@
 
 #include <panda/data/DataNode.h>
 #include <panda/helper/Flags.h>
+#include <panda/helper/StringTable.h>
 
 namespace panda
 {
@@ -55,9 +56,10 @@ public:
 
 	explicit BaseData(const BaseInitData& init, const std::type_info& type);
 	BaseData(const std::string& name, const std::string& help, PandaObject* owner, const std::type_info& type);
-	virtual ~BaseData() {}
+	virtual ~BaseData();
 
 	const std::string& getName() const;	/// Name used in the UI and for saving / loading
+	helper::StringId getNameId() const; /// Id of the name in the string table
 	void setName(const std::string& name);
 	const std::string& getHelp() const;	/// Message describing the Data
 	void setHelp(const std::string& help);
@@ -71,6 +73,7 @@ public:
 	void forceSet();	/// Consider the current value as changed
 
 	virtual int getCounter() const; /// The counter usually increments at each value change (after disconnecting from a parent, can decrement quite a bit)
+	const BaseData* getCounterSource() const; /// The Data whose counter is returned by getCounter (counters of different Datas can be equal, compare both)
 
 	bool isReadOnly() const;	/// Only used in the UI, automatically set if the Data is an input
 	void setReadOnly(bool readOnly);
@@ -93,7 +96,9 @@ public:
 	BaseData* getParent() const; /// Returns the current parent, or nullptr
 
 	const types::AbstractDataTrait* getDataTrait() const; /// Return a class describing the type stored in this Data
+	int getTypeId() const; /// Full type id of the value (same as getDataTrait()->fullTypeId(), without the virtual call)
 	virtual const void* getVoidValue() const = 0; /// Return a void* pointing to the value (use the DataTrait to exploit it)
+	virtual std::size_t getHeapSize() const = 0; /// Memory allocated by the value stored in this Data (a shared buffer is divided between the Datas using it), does not update the Data
 	VoidDataAccessor getVoidAccessor(); /// Return a wrapper around the void*, that will call endEdit when destroyed
 
 	virtual std::string getDescription() const; /// Get a readable name of the type stored in this Data
@@ -105,6 +110,14 @@ public:
 
 	void setDirtyValue(const DataNode* caller) override;
 
+	// Used by the pipelined mode of the Scheduler, when the parent is modified for the next step while this value is used for rendering
+	virtual void freeze(); /// Keep a copy of the value of the parent, returned instead of it until unfreeze is called
+	bool unfreeze(); /// Use the parent again, and set the outputs dirty if its value changed in the meantime (returns true in that case)
+	bool isFrozen() const;
+
+	// Used by the modifiers to reuse the buffer of their input instead of copying it
+	bool canTakeParentValue() const; /// Is this Data the only consumer of its parent, an output computed again at each step before being read
+
 protected:
 	virtual void doAddInput(DataNode& node) override;
 	virtual void doRemoveInput(DataNode& node) override;
@@ -116,6 +129,8 @@ protected:
 	virtual void endVoidEdit() = 0;
 
 	void initInternals(const std::type_info& type);
+	void valueTaken(); /// The value was moved to another Data, it must be computed again if read
+	std::size_t valueHeapSize(const void* value) const; /// Use the DataTrait to get the memory allocated by the value
 
 	enum class DataOption : uint32_t
 	{
@@ -126,20 +141,24 @@ protected:
 		Output = 1 << 4, /// Is it an output of an object
 		ValueSet = 1 << 5, /// Was the value modified from the default
 		SetParentProtection = 1 << 6, /// (internal) Are we modifying the parentage of this data
-		DynamicallyCreated = 1 << 7 /// Is it created after the initial creation of the object
+		DynamicallyCreated = 1 << 7, /// Is it created after the initial creation of the object
+		Frozen = 1 << 8 /// (internal) Is the value a copy of the parent's, ignoring its modifications
 	};
 	using DataOptions = helper::Flags<DataOption>;
 
 	void setFlag(DataOption flag, bool b);
 	bool getFlag(DataOption flag) const;
 
-	DataOptions m_dataFlags = DataOptions(DataOption::Displayed) | DataOption::Persistent;
+	// The fields used during the updates come first (the dirty state is in DataNode)
 	int m_counter = 0;
-	PandaObject* m_owner = nullptr;
+	DataOptions m_dataFlags = DataOptions(DataOption::Displayed) | DataOption::Persistent;
 	BaseData* m_parentBaseData = nullptr;
+	PandaObject* m_owner = nullptr;
 	types::AbstractDataTrait* m_dataTrait = nullptr;
 	AbstractDataCopier* m_dataCopier = nullptr;
-	std::string m_name, m_help, m_widget, m_widgetData;
+	int m_frozenCounter = 0; /// Counter of the parent when the value was frozen
+	int m_typeId = 0; /// Full type id of the value, 0 if the type is not registered
+	helper::StringId m_name = 0, m_help = 0, m_widget = 0, m_widgetData = 0; // In the string table, as most Datas share them with Datas of other objects
 
 private:
 	BaseData() {}
@@ -160,28 +179,31 @@ inline VoidDataAccessor::operator void *()
 { return m_value; }
 
 inline const std::string& BaseData::getName() const
+{ return helper::internedString(m_name); }
+
+inline helper::StringId BaseData::getNameId() const
 { return m_name; }
 
 inline void BaseData::setName(const std::string& name)
-{ m_name = name; }
+{ m_name = helper::internString(name); }
 
 inline const std::string& BaseData::getHelp() const
-{ return m_help; }
+{ return helper::internedString(m_help); }
 
 inline void BaseData::setHelp(const std::string& help)
-{ m_help = help; }
+{ m_help = helper::internString(help); }
 
 inline const std::string& BaseData::getWidget() const
-{ return m_widget; }
+{ return helper::internedString(m_widget); }
 
 inline void BaseData::setWidget(const std::string& widget)
-{ m_widget = widget; }
+{ m_widget = helper::internString(widget); }
 
 inline const std::string& BaseData::getWidgetData() const
-{ return m_widgetData; }
+{ return helper::internedString(m_widgetData); }
 
 inline void BaseData::setWidgetData(const std::string& widgetData)
-{ m_widgetData = widgetData; }
+{ m_widgetData = helper::internString(widgetData); }
 
 inline bool BaseData::isSet() const
 { return getFlag(DataOption::ValueSet); }
@@ -192,8 +214,14 @@ inline void BaseData::unset()
 inline void BaseData::forceSet()
 { setFlag(DataOption::ValueSet, true); }
 
+inline bool BaseData::isFrozen() const
+{ return getFlag(DataOption::Frozen); }
+
 inline int BaseData::getCounter() const
-{ if(m_parentBaseData) return m_parentBaseData->getCounter(); return m_counter; }
+{ if(isFrozen()) return m_frozenCounter; if(m_parentBaseData) return m_parentBaseData->getCounter(); return m_counter; }
+
+inline const BaseData* BaseData::getCounterSource() const
+{ if(isFrozen() || !m_parentBaseData) return this; return m_parentBaseData->getCounterSource(); }
 
 inline bool BaseData::isReadOnly() const
 { return getFlag(DataOption::ReadOnly); }
@@ -243,6 +271,9 @@ inline BaseData* BaseData::getParent() const
 inline const types::AbstractDataTrait* BaseData::getDataTrait() const
 { return m_dataTrait; }
 
+inline int BaseData::getTypeId() const
+{ return m_typeId; }
+
 inline VoidDataAccessor BaseData::getVoidAccessor()
 { return VoidDataAccessor(this); }
 
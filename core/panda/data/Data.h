@@ -3,7 +3,9 @@
 
 #include <panda/data/BaseData.h>
 #include <panda/data/DataAccessor.h>
+#include <panda/data/DataValue.h>
 #include <panda/helper/UpdateLogger.h>
+#include <panda/types/DataTraits.h>
 
 namespace panda
 {
@@ -29,10 +31,14 @@ public:
 	virtual void update() override;
 
 	virtual void setParent(BaseData* parent) override;
+	virtual void freeze() override;
 	virtual const void* getVoidValue() const override;
+	virtual std::size_t getHeapSize() const override;
 	data_accessor getAccessor(); /// Return a wrapper around the pointer to the value (call endEdit in the destructor)
 	inline void setValue(const_reference value); /// Store value in this Data
 	inline const_reference getValue() const; /// Retrieve the stored value
+	void shareValue(const Data& from); /// Use the value of another Data (a vector is shared until one of them modifies it)
+	void takeValue(Data& input); /// Move the value of the parent of input if input is its only consumer (see BaseData::canTakeParentValue), else share it. Read input before, not after.
 
 	virtual int getCounter() const override;
 
@@ -44,15 +50,24 @@ protected:
 	virtual void* beginVoidEdit();
 	virtual void endVoidEdit();
 
+	const DataValue<value_type>& sharedValue() const; /// The storage of the value, found by following the parents
+
 private:
-	value_type m_value;
+	DataValue<value_type> m_value;
 	Data<value_type>* m_parentData;
+	int m_convertedCounter = -1; // Counter of the parent (of a different type) when its value was copied in m_value
+	const BaseData* m_convertedSource = nullptr; // The Data that provided this counter (the parent or one of its own parents)
 
 	Data();
 	Data(const Data&);
 	Data& operator=(const Data&);
 };
 
+/// Cast a BaseData to a Data of the exact type, using the type id stored in the BaseData instead of dynamic_cast
+/// Return nullptr if the value of data is not of this type (no conversion is done)
+template <class DataType> DataType* data_cast(BaseData* data);
+template <class DataType> const DataType* data_cast(const BaseData* data);
+
 //****************************************************************************//
 
 template<class T>
@@ -86,7 +101,6 @@ public:
 template<class T>
 Data<T>::Data(const BaseData::BaseInitData& init)
 	: BaseData(init, typeid(T))
-	, m_value(value_type())
 	, m_parentData(nullptr)
 {
 }
@@ -97,13 +111,12 @@ Data<T>::Data(const BaseData::InitData<U>& init)
 	: BaseData(init, typeid(T))
 	, m_parentData(nullptr)
 {
-	m_value = static_cast<T>(init.value);
+	m_value.set(static_cast<T>(init.value));
 }
 
 template<class T>
 Data<T>::Data(const std::string& name, const std::string& help, PandaObject* owner)
 	: BaseData(name, help, owner, typeid(T))
-	, m_value(T())
 	, m_parentData(nullptr)
 {
 }
@@ -126,8 +139,20 @@ void Data<T>::update()
 
 	if(!m_parentData && m_parentBaseData)
 	{
+		if(!beginUpdate()) // Already converted by another thread, or reentrant call from copyValueFrom
+			return;
+
 		cleanDirty();
-		copyValueFrom(m_parentBaseData);
+		const int parentCounter = m_parentBaseData->getCounter();
+		const BaseData* parentSource = m_parentBaseData->getCounterSource();
+		if(parentCounter != m_convertedCounter || parentSource != m_convertedSource) // Only convert the value again if the parent was modified or relinked
+		{
+			copyValueFrom(m_parentBaseData);
+			m_convertedCounter = parentCounter;
+			m_convertedSource = parentSource;
+		}
+		endUpdate();
+		return;
 	}
 
 	cleanDirty();
@@ -136,24 +161,43 @@ void Data<T>::update()
 template<class T>
 void Data<T>::setParent(BaseData* parent)
 {
+	if(parent != m_parentBaseData)
+	{
+		setFlag(DataOption::Frozen, false);
+		m_convertedSource = nullptr;
+	}
+
 	// Treating disconnection of a data
 	if(!parent && !getFlag(DataOption::SetParentProtection))
 	{
 		if(!isPersistent()) // If the data is not persistent, we reset the value
 		{
-			m_value = T();
+			m_value.set(T());
 			BaseData::setDirtyValue(this);
 		}
 		else if(m_parentData)	// Else we copy the data if we never copied it
-			m_value = m_parentData->getValue();
+			m_value.share(m_parentData->sharedValue());
 	}
 
 	// getValue is optimized when the parent is of the same type as this data
-	m_parentData = dynamic_cast< Data<T>* >(parent);
+	m_parentData = data_cast< Data<T> >(parent);
 
 	BaseData::setParent(parent);
 }
 
+template<class T>
+void Data<T>::freeze()
+{
+	if(!m_parentBaseData)
+		return;
+
+	updateIfDirty(); // If the parent has a different type, the converted value is now in m_value
+	if(m_parentData)
+		m_value.share(m_parentData->sharedValue()); // The parent will make its own copy when modified
+
+	BaseData::freeze();
+}
+
 template<class T>
 DataAccessor<typename Data<T>::data_type> Data<T>::getAccessor()
 {
@@ -164,15 +208,58 @@ template<class T>
 typename Data<T>::const_reference Data<T>::getValue() const
 {
 	helper::ScopedEvent log(helper::event_getValue, this);
+	if(isFrozen()) // The parent is being modified for the next step
+		return m_value.get();
 	updateIfDirty();
 	if(m_parentData)
 		return m_parentData->getValue();
+	return m_value.get();
+}
+
+template<class T>
+const DataValue<T>& Data<T>::sharedValue() const
+{
+	if(isFrozen())
+		return m_value;
+	updateIfDirty();
+	if(m_parentData)
+		return m_parentData->sharedValue();
 	return m_value;
 }
 
+template<class T>
+void Data<T>::shareValue(const Data& from)
+{
+	const auto& value = from.sharedValue();
+	updateIfDirty();
+	++m_counter;
+	m_value.share(value);
+	endEdit();
+}
+
+template<class T>
+void Data<T>::takeValue(Data& input)
+{
+	Data* source = input.m_parentData;
+	if(!source || !input.canTakeParentValue())
+	{
+		shareValue(input);
+		return;
+	}
+
+	input.updateIfDirty(); // Updates the parent and cleans input, so that it propagates the next modifications of the parent
+	updateIfDirty();
+	++m_counter;
+	m_value.take(source->m_value);
+	source->valueTaken();
+	endEdit();
+}
+
 template<class T>
 int Data<T>::getCounter() const
 {
+	if(isFrozen())
+		return m_frozenCounter;
 	if(m_parentData)
 		return m_parentData->getCounter();
 	return BaseData::getCounter();
@@ -190,6 +277,12 @@ template<class T>
 inline const void* Data<T>::getVoidValue() const
 { return &getValue(); }
 
+template<class T>
+std::size_t Data<T>::getHeapSize() const
+{
+	return valueHeapSize(&m_value.get()) / m_value.useCount();
+}
+
 template<class T>
 inline void Data<T>::setValue(const_reference value)
 {
@@ -202,17 +295,33 @@ inline typename Data<T>::reference Data<T>::beginEdit()
 {
 	updateIfDirty();
 	++m_counter;
-	return m_value;
+	return m_value.edit();
 }
 
 template<class T>
 inline void Data<T>::endEdit()
 {
+	m_convertedSource = nullptr; // Modified directly, the next update must convert the value of the parent again
 	forceSet();
 	cleanDirty();
 	BaseData::setDirtyOutputs();
 }
 
+//****************************************************************************//
+
+template <class DataType>
+inline DataType* data_cast(BaseData* data)
+{
+	static_assert(std::is_same<DataType, Data<typename DataType::value_type>>::value, "data_cast only works with Data<T>");
+	if(data && data->getTypeId() == types::DataTrait<typename DataType::value_type>::fullTypeId())
+		return static_cast<DataType*>(data);
+	return nullptr;
+}
+
+template <class DataType>
+inline const DataType* data_cast(const BaseData* data)
+{ return data_cast<DataType>(const_cast<BaseData*>(data)); }
+
 } // namespace panda
 
 #endif // DATA_H
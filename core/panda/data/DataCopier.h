@@ -48,17 +48,17 @@ bool DataCopier<T>::copyData(Data<T> *dest, const BaseData* from)
 	if(fromTrait->isSingleValue())
 	{
 		// Same type
-		const Data<T>* castedFrom = dynamic_cast<const Data<T>*>(from);
+		const Data<T>* castedFrom = data_cast< Data<T> >(from);
 		if(castedFrom)
 		{
-			dest->setValue(castedFrom->getValue());
+			dest->shareValue(*castedFrom);
 			return true;
 		}
 	}
 	else if(fromTrait->isVector())
 	{
 		// The from is a vector of T
-		const Data< std::vector<T> >* castedVectorFrom = dynamic_cast<const Data< std::vector<T> >*>(from);
+		const Data< std::vector<T> >* castedVectorFrom = data_cast< Data< std::vector<T> > >(from);
 		if(castedVectorFrom)
 		{
 			if(castedVectorFrom->getValue().size())
@@ -114,17 +114,17 @@ public:
 		if(fromTrait->isVector())
 		{
 			// Same type (both vectors)
-			const data_type* castedFrom = dynamic_cast<const data_type*>(from);
+			const data_type* castedFrom = data_cast<data_type>(from);
 			if(castedFrom)
 			{
-				dest->setValue(castedFrom->getValue());
+				dest->shareValue(*castedFrom);
 				return true;
 			}
 		}
 		else if(fromTrait->isSingleValue())
 		{
 			// The from is not a vector of T, but a single value of type T
-			const Data<value_type>* castedSingleValueFrom = dynamic_cast<const Data<value_type>*>(from);
+			const Data<value_type>* castedSingleValueFrom = data_cast< Data<value_type> >(from);
 			if(castedSingleValueFrom)
 			{
 				auto vec = dest->getAccessor();
@@ -146,18 +146,27 @@ public:
 		}
 
 		// From a single value or vector of X to vector of Y
-		if(types::TypeConverter::canConvert(fromValueTypeId, destValueTypeId))
+		auto valueConverter = types::TypeConverter::getConverter(fromValueTypeId, destValueTypeId);
+		if(valueConverter)
 		{
 			const void* fromPtr = from->getVoidValue();
 			auto toValue = dest->getAccessor();
 			int size = fromTrait->size(fromPtr);
 			DestTrait::clear(toValue.wref(), size, true);
-			for(int i=0; i<size; ++i)
+			if(!size)
+				return true;
+
+			if(fromTrait->isVector()) // Both values are contiguous, convert them in one call
+				valueConverter->convertArray(fromTrait->getVoidValue(fromPtr, 0), toValue.wref().data(), size);
+			else
 			{
-				const void* fromValuePtr = fromTrait->getVoidValue(fromPtr, i);
-				void* toValuePtr = DestTrait::getVoidValue(toValue.wref(), i);
-				if(fromValuePtr && toValuePtr)
-					types::TypeConverter::convert(fromValueTypeId, destValueTypeId, fromValuePtr, toValuePtr);
+				for(int i=0; i<size; ++i)
+				{
+					const void* fromValuePtr = fromTrait->getVoidValue(fromPtr, i);
+					void* toValuePtr = DestTrait::getVoidValue(toValue.wref(), i);
+					if(fromValuePtr && toValuePtr)
+						valueConverter->convert(fromValuePtr, toValuePtr);
+				}
 			}
 			return true;
 		}
@@ -208,10 +217,10 @@ public:
 		if(fromTrait->isAnimation())
 		{
 			// Same type (both animations)
-			const data_type* castedAnimationFrom = dynamic_cast<const data_type*>(from);
+			const data_type* castedAnimationFrom = data_cast<data_type>(from);
 			if(castedAnimationFrom)
 			{
-				dest->setValue(castedAnimationFrom->getValue());
+				dest->shareValue(*castedAnimationFrom);
 				return true;
 			}
 		}
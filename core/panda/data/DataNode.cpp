@@ -1,12 +1,21 @@
 #include <panda/data/DataNode.h>
 
 #include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Nodes being updated by the current thread, to detect the reentrant calls
+	thread_local std::vector<const panda::DataNode*> updatingNodes;
+}
 
 namespace panda
 {
 
-DataNode::DataNode()
-	: m_dirtyValue(false)
+DataNode::DataNode(NodeKind kind)
+	: m_state(0)
+	, m_nodeKind(kind)
 {
 }
 
@@ -54,4 +63,36 @@ void DataNode::doRemoveOutput(DataNode& node)
 	m_outputs.erase(std::remove(m_outputs.begin(), m_outputs.end(), &node), m_outputs.end()); 
 }
 
+bool DataNode::beginUpdate(bool wait) const
+{
+	uint8_t state = m_state.load(std::memory_order_acquire);
+	while(true)
+	{
+		if(state & Updating)
+		{
+			if(!wait || std::find(updatingNodes.begin(), updatingNodes.end(), this) != updatingNodes.end())
+				return false;
+
+			std::this_thread::yield(); // Another thread is updating this node, its value will soon be valid
+			state = m_state.load(std::memory_order_acquire);
+			continue;
+		}
+
+		if(!(state & Dirty))
+			return false;
+
+		if(m_state.compare_exchange_weak(state, state | Updating, std::memory_order_acquire))
+		{
+			updatingNodes.push_back(this);
+			return true;
+		}
+	}
+}
+
+void DataNode::endUpdate() const
+{
+	updatingNodes.pop_back();
+	m_state.fetch_and(static_cast<uint8_t>(~Updating), std::memory_order_release);
+}
+
 } // namespace panda
@@ -2,19 +2,29 @@
 #define DATANODE_H
 
 #include <panda/data/BaseClass.h>
+#include <panda/helper/SmallVector.h>
+
+#include <atomic>
 
 namespace panda
 {
 
+class PandaDocument;
+
+enum class NodeKind : char { Other, Data, Object };
+
 class PANDA_CORE_API DataNode
 {
 public:
 	PANDA_ABSTRACT_CLASS(DataNode, void)
-	typedef std::vector<DataNode*> NodesList;
+	typedef helper::SmallVector<DataNode*, 2> NodesList; // Most Datas have at most 2 connections, stored inside the node
 
-	DataNode();
+	explicit DataNode(NodeKind kind = NodeKind::Other);
 	virtual ~DataNode();
 
+	NodeKind nodeKind() const; /// Is this a BaseData or a PandaObject (can be used instead of a dynamic_cast)
+	uint32_t nodeId() const; /// Dense index given by the document (0 if the node is not in a document)
+
 	virtual void addInput(DataNode& node);
 	virtual void removeInput(DataNode& node);
 	virtual void addOutput(DataNode& node);
@@ -31,7 +41,7 @@ public:
 
 	virtual void setDirtyValue(const DataNode* caller); /// Change the flag and propagate to all outputs
 	virtual void setDirtyOutputs(); /// Propagate the change to all outputs
-	virtual void updateIfDirty() const;
+	virtual void updateIfDirty() const; /// Call update if the node is dirty, or if another thread is updating it (to wait for it)
 
 	virtual void doAddInput(DataNode& node);
 	virtual void doRemoveInput(DataNode& node);
@@ -39,7 +49,18 @@ public:
 	virtual void doRemoveOutput(DataNode& node);
 
 protected:
-	bool m_dirtyValue;
+	friend class PandaDocument;
+	void setNodeId(uint32_t id); /// Only the document can set the id of the node
+
+	// Update latch: when multiple threads read a dirty node, only one of them updates it and the others wait
+	bool beginUpdate(bool wait = true) const; /// Returns true if the calling thread must update the node (then call endUpdate), false if it is clean or already being updated (by this thread, or by another one if not waiting)
+	void endUpdate() const;
+	bool isDirtyOrUpdating() const;
+
+	enum StateFlags : uint8_t { Dirty = 1 << 0, Updating = 1 << 1 };
+	mutable std::atomic<uint8_t> m_state; // Can be read and modified by multiple threads
+	NodeKind m_nodeKind;
+	uint32_t m_nodeId = 0;
 	NodesList m_inputs, m_outputs;
 };
 
@@ -51,12 +72,24 @@ inline const DataNode::NodesList& DataNode::getInputs() const
 inline const DataNode::NodesList& DataNode::getOutputs() const
 { return m_outputs; }
 
+inline NodeKind DataNode::nodeKind() const
+{ return m_nodeKind; }
+
+inline uint32_t DataNode::nodeId() const
+{ return m_nodeId; }
+
+inline void DataNode::setNodeId(uint32_t id)
+{ m_nodeId = id; }
+
 inline bool DataNode::isDirty() const
-{ return m_dirtyValue; }
+{ return (m_state.load(std::memory_order_acquire) & Dirty) != 0; }
+
+inline bool DataNode::isDirtyOrUpdating() const
+{ return m_state.load(std::memory_order_acquire) != 0; }
 
 inline void DataNode::setDirtyValue(const DataNode* /*caller*/)
 {
-	if(!m_dirtyValue)
+	if(!isDirty())
 	{
 		doSetDirty();
 		setDirtyOutputs();
@@ -64,7 +97,7 @@ inline void DataNode::setDirtyValue(const DataNode* /*caller*/)
 }
 
 inline void DataNode::doSetDirty()
-{ m_dirtyValue = true; }
+{ m_state.fetch_or(Dirty, std::memory_order_acq_rel); }
 
 inline void DataNode::setDirtyOutputs()
 {
@@ -73,11 +106,11 @@ inline void DataNode::setDirtyOutputs()
 }
 
 inline void DataNode::cleanDirty()
-{ m_dirtyValue = false; }
+{ m_state.fetch_and(static_cast<uint8_t>(~Dirty), std::memory_order_release); }
 
 inline void DataNode::updateIfDirty() const
 {
-	if(isDirty())
+	if(isDirtyOrUpdating()) // The derived classes take the update latch around the actual computations (see beginUpdate)
 		const_cast<DataNode*>(this)->update();
 }
 
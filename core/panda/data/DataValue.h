@@ -0,0 +1,71 @@
+#ifndef DATAVALUE_H
+#define DATAVALUE_H
+
+#include <memory>
+#include <vector>
+
+namespace panda
+{
+
+/// Storage of the value of a Data
+template<class T>
+class DataValue
+{
+public:
+	typedef T value_type;
+
+	DataValue() : m_value() {}
+	explicit DataValue(const value_type& value) : m_value(value) {}
+
+	const value_type& get() const { return m_value; }
+	value_type& edit() { return m_value; }
+	void set(const value_type& value) { m_value = value; }
+	void share(const DataValue& other) { m_value = other.m_value; } /// Only vectors can really be shared, the other types are copied
+	void take(DataValue& other) { m_value = std::move(other.m_value); other.m_value = value_type(); } /// Move the value of the other Data, leaving it empty
+	long useCount() const { return 1; } /// Number of Datas sharing this value
+
+private:
+	value_type m_value;
+};
+
+//****************************************************************************//
+
+/// Vectors are reference-counted buffers, shared between Datas until one of them is modified (copy-on-write)
+template<class T>
+class DataValue< std::vector<T> >
+{
+public:
+	typedef std::vector<T> value_type;
+
+	DataValue() {}
+	explicit DataValue(const value_type& value) { set(value); }
+
+	const value_type& get() const { return m_ptr ? *m_ptr : empty(); }
+	value_type& edit()
+	{
+		if(!m_ptr)
+			m_ptr = std::make_shared<value_type>();
+		else if(m_ptr.use_count() > 1) // Detach from the other Datas before modifying the value
+			m_ptr = std::make_shared<value_type>(*m_ptr);
+		return *m_ptr;
+	}
+	void set(const value_type& value)
+	{
+		if(m_ptr && m_ptr.use_count() == 1)
+			*m_ptr = value; // Reuse the memory we already have
+		else
+			m_ptr = std::make_shared<value_type>(value);
+	}
+	void share(const DataValue& other) { m_ptr = other.m_ptr; }
+	void take(DataValue& other) { m_ptr = std::move(other.m_ptr); } // If it was the only owner, the next edit will not copy the buffer
+	long useCount() const { return m_ptr ? m_ptr.use_count() : 1; }
+
+private:
+	static const value_type& empty() { static const value_type emptyValue; return emptyValue; }
+
+	std::shared_ptr<value_type> m_ptr; // Null while empty
+};
+
+} // namespace panda
+
+#endif // DATAVALUE_H
@@ -7,6 +7,7 @@
 
 namespace panda {
 
+class BaseData;
 class DockableObject;
 class PandaObject;
 class XmlElement;
@@ -21,6 +22,7 @@ public:
 	msg::Signal<void()> startLoading;
 	msg::Signal<void()> loadingFinished;
 	msg::Signal<void(panda::DockableObject*)> changedDock;
+	msg::Signal<void(panda::BaseData*)> changedLink;
 	msg::Signal<void(int buttonId, bool isPressed, panda::types::Point localPos)> mouseButtonEvent;
 	msg::Signal<void(panda::types::Point localPos, panda::types::Point globalPos)> mouseMoveEvent;
 	msg::Signal<void(int key, bool isPressed)> keyEvent;
@@ -101,8 +101,8 @@ void forEachObjectOutput(PandaObject* startObject, ObjectFunctor func)
 {
 	for(auto output : startObject->getOutputs())
 	{
-		PandaObject* object = dynamic_cast<PandaObject*>(output);
-		BaseData* data = dynamic_cast<BaseData*>(output);
+		PandaObject* object = asObject(output);
+		BaseData* data = asData(output);
 		if(object) // Some objects can be directly connected to others objects (Docks and Dockable for example)
 		{
 			func(object);
@@ -111,8 +111,8 @@ void forEachObjectOutput(PandaObject* startObject, ObjectFunctor func)
 		{
 			for(auto node : data->getOutputs())
 			{
-				PandaObject* object2 = dynamic_cast<PandaObject*>(node);
-				BaseData* data2 = dynamic_cast<BaseData*>(node);
+				PandaObject* object2 = asObject(node);
+				BaseData* data2 = asData(node);
 				if(object2)
 				{ // Output data directly connected to another object
 					func(object2);
@@ -127,7 +127,7 @@ void forEachObjectOutput(PandaObject* startObject, ObjectFunctor func)
 					{ // Groups can have inside object's data connected to the group's data, connected to outside object's data.
 						for(auto node2 : data2->getOutputs())
 						{
-							BaseData* data3 = dynamic_cast<BaseData*>(node2);
+							BaseData* data3 = asData(node2);
 							if(data3 && data3->getOwner())
 								func(data3->getOwner());
 						}
@@ -142,8 +142,8 @@ void forEachObjectInput(PandaObject* startObject, ObjectFunctor func)
 {
 	for(auto output : startObject->getInputs())
 	{
-		PandaObject* object = dynamic_cast<PandaObject*>(output);
-		BaseData* data = dynamic_cast<BaseData*>(output);
+		PandaObject* object = asObject(output);
+		BaseData* data = asData(output);
 		if(object) // Some objects can be directly connected to others objects (Docks and Dockable for example)
 		{
 			func(object);
@@ -152,8 +152,8 @@ void forEachObjectInput(PandaObject* startObject, ObjectFunctor func)
 		{
 			for(auto node : data->getInputs())
 			{
-				PandaObject* object2 = dynamic_cast<PandaObject*>(node);
-				BaseData* data2 = dynamic_cast<BaseData*>(node);
+				PandaObject* object2 = asObject(node);
+				BaseData* data2 = asData(node);
 				if(object2)
 				{ // Output data directly connected to another object
 					func(object2);
@@ -168,7 +168,7 @@ void forEachObjectInput(PandaObject* startObject, ObjectFunctor func)
 					{ // Groups can have inside object's data connected to the group's data, connected to outside object's data.
 						for(auto node2 : data2->getInputs())
 						{
-							BaseData* data3 = dynamic_cast<BaseData*>(node2);
+							BaseData* data3 = asData(node2);
 							if(data3 && data3->getOwner())
 								func(data3->getOwner());
 						}
@@ -190,7 +190,7 @@ std::vector<DataNode*> computeConnectedInputNodes(DataNode* originNode, bool kee
 		openList.pop_front();
 		closedList.insert(currentNode);
 
-		std::vector<DataNode*> inputs;
+		DataNode::NodesList inputs;
 		if(keepRecursive)
 			inputs = currentNode->getInputs();
 		else
@@ -223,7 +223,7 @@ std::vector<DataNode*> computeConnectedOutputNodes(DataNode* originNode, bool ke
 		openList.pop_front();
 		closedList.insert(currentNode);
 
-		std::vector<DataNode*> outputs;
+		DataNode::NodesList outputs;
 		if(keepRecursive)
 			outputs = currentNode->getOutputs();
 		else
@@ -0,0 +1,40 @@
+#ifndef DOCUMENT_MEMORYUSAGE_H
+#define DOCUMENT_MEMORYUSAGE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace panda
+{
+
+class BaseData;
+class PandaObject;
+
+/// Memory allocated by the value of a Data (see BaseData::getHeapSize)
+struct DataMemoryUsage
+{
+	const BaseData* data = nullptr;
+	std::size_t size = 0;
+};
+
+/// Memory used by an object: the values of its Datas and what it keeps between steps
+struct ObjectMemoryUsage
+{
+	PandaObject* object = nullptr;
+	std::size_t internalSize = 0; // See PandaObject::getInternalHeapSize
+	std::size_t totalSize = 0; // Sum of the Datas and of the internal size
+	std::vector<DataMemoryUsage> datas;
+};
+
+using MemoryUsage = std::vector<ObjectMemoryUsage>;
+
+/// Total memory used by the document at the end of a step
+struct MemoryFrame
+{
+	float time = 0; // Animation time of the step
+	std::size_t totalSize = 0;
+};
+
+} // namespace panda
+
+#endif // DOCUMENT_MEMORYUSAGE_H
@@ -5,7 +5,9 @@
 #include <panda/document/DocumentSignals.h>
 #include <panda/document/ObjectsList.h>
 #include <panda/document/Scheduler.h>
+#include <panda/helper/Arena.h>
 #include <panda/helper/UpdateLogger.h>
+#include <panda/object/Group.h>
 
 #include <chrono>
 
@@ -27,6 +29,32 @@ double toSeconds(long long elapsed)
 	return duration_cast<duration<double>>(durSec).count();
 }
 
+const std::size_t maxMemoryFrames = 10000; // Number of steps kept in the memory history
+
+void addMemoryUsage(panda::MemoryUsage& usage, panda::PandaObject* object)
+{
+	panda::ObjectMemoryUsage objectUsage;
+	objectUsage.object = object;
+	objectUsage.internalSize = object->getInternalHeapSize();
+	objectUsage.totalSize = objectUsage.internalSize;
+	for (auto data : object->getDatas())
+	{
+		panda::DataMemoryUsage dataUsage;
+		dataUsage.data = data;
+		dataUsage.size = data->getHeapSize();
+		objectUsage.totalSize += dataUsage.size;
+		objectUsage.datas.push_back(dataUsage);
+	}
+	usage.push_back(std::move(objectUsage));
+
+	auto group = dynamic_cast<panda::Group*>(object);
+	if (group)
+	{
+		for (const auto& child : group->getObjectsList().get())
+			addMemoryUsage(usage, child.get());
+	}
+}
+
 }
 
 namespace panda {
@@ -38,6 +66,10 @@ PandaDocument::PandaDocument(gui::BaseGUI& gui)
 	, m_timestep(initData(0.01, "timestep", "Time step of the animation"))
 	, m_useTimer(initData(1, "use timer", "If true, wait before the next timestep. If false, compute the next one as soon as the previous finished."))
 	, m_nbThreads(initData(0, "nb threads", "Optimize computation for multiple CPU cores (not using the scheduler if < 0)"))
+	, m_threadsSpinTime(initData(100, "threads spin time", "Time in microseconds an idle thread waits actively before blocking (0 to block immediately, -1 to never block)"))
+	, m_pipelinedFrames(initData(0, "pipelined frames", "If true and using multiple threads, compute the next step while rendering the current one. The image is then one step late."))
+	, m_earlyCutoff(initData(0, "early cutoff", "If true and using multiple threads, do not update objects when the values of their inputs did not change."))
+	, m_fusionThreshold(initData(0.f, "fusion threshold", "If not 0 and using multiple threads, chains of objects cheaper than this (in microseconds) are updated by the same thread, one after the other."))
 	, m_gui(gui)
 	, m_objectsList(std::make_unique<ObjectsList>())
 	, m_signals(std::make_unique<DocumentSignals>())
@@ -46,8 +78,14 @@ PandaDocument::PandaDocument(gui::BaseGUI& gui)
 	addInput(m_timestep);
 	addInput(m_useTimer);
 	addInput(m_nbThreads);
+	addInput(m_threadsSpinTime);
+	addInput(m_pipelinedFrames);
+	addInput(m_earlyCutoff);
+	addInput(m_fusionThreshold);
 
 	m_useTimer.setWidget("checkbox");
+	m_pipelinedFrames.setWidget("checkbox");
+	m_earlyCutoff.setWidget("checkbox");
 
 	// Not connecting to the document, otherwise it would update the layers each time we get the time.
 	m_animTime.setOutput(true);
@@ -58,6 +96,9 @@ PandaDocument::PandaDocument(gui::BaseGUI& gui)
 	m_undoStack->setUndoLimit(25);
 
 	setParentDocument(this);
+	assignNodeId(*this);
+	for(auto data : getDatas())
+		assignNodeId(*data);
 }
 
 PandaDocument::~PandaDocument()
@@ -75,22 +116,46 @@ PandaDocument::~PandaDocument()
 
 void PandaDocument::setDataDirty(BaseData* data) const
 {
-	if(m_animMultithread && m_scheduler)
+	if(useScheduler())
 		m_scheduler->setDataDirty(data);
 }
 
 void PandaDocument::setDataReady(BaseData* data) const
 {
-	if(m_animMultithread && m_scheduler)
+	if(useScheduler())
 		m_scheduler->setDataReady(data);
 }
 
 void PandaDocument::waitForOtherTasksToFinish(bool mainThread) const
 {
-	if(m_animMultithread && m_scheduler)
+	if(useScheduler())
 		m_scheduler->waitForOtherTasks(mainThread);
 }
 
+void PandaDocument::parallelFor(int nbChunks, const std::function<void(int)>& func) const
+{
+	if(useScheduler())
+		m_scheduler->parallelFor(nbChunks, func);
+	else
+	{
+		for(int i = 0; i < nbChunks; ++i)
+			func(i);
+	}
+}
+
+int PandaDocument::getNbParallelThreads() const
+{
+	if(useScheduler())
+		return m_scheduler->nbThreads();
+	return 1;
+}
+
+bool PandaDocument::canTakeValue(const BaseData* output) const
+{
+	// Only during the animation, where the Scheduler knows which objects are updated at each step
+	return m_animMultithread && m_scheduler && m_scheduler->canTakeValue(output);
+}
+
 void PandaDocument::onDirtyObject(PandaObject* object)
 {
 	if(m_isResetting)
@@ -124,10 +189,40 @@ void PandaDocument::onChangedDock(DockableObject* dockable)
 	m_signals->changedDock.run(dockable);
 }
 
+void PandaDocument::onChangedLink(BaseData* data)
+{
+	if(m_isResetting)
+		return;
+
+	m_signals->changedLink.run(data);
+}
+
 void PandaDocument::update()
 {
 	if(m_animMultithread && m_scheduler)
 		m_scheduler->update();
+	else if(!m_animPlaying && !m_schedulerUpdate && !m_isResetting)
+		updateWithScheduler();
+}
+
+void PandaDocument::updateWithScheduler()
+{
+	int nbThreads = m_nbThreads.getValue();
+	if(!nbThreads)
+		return; // The objects will be updated recursively when their outputs are read
+
+	// The graph and the threads are kept between the updates
+	if(!m_scheduler)
+		m_scheduler = std::make_unique<Scheduler>(this);
+	m_scheduler->setSpinDuration(m_threadsSpinTime.getValue());
+	m_scheduler->setPipelined(false);
+	m_scheduler->setEarlyCutoff(false);
+	m_scheduler->setFusionThreshold(m_fusionThreshold.getValue());
+	m_scheduler->init(nbThreads);
+
+	m_schedulerUpdate = true;
+	m_scheduler->updateDirtyObjects();
+	m_schedulerUpdate = false;
 }
 
 void PandaDocument::play(bool playing)
@@ -142,6 +237,10 @@ void PandaDocument::play(bool playing)
 		{
 			if(!m_scheduler)
 				m_scheduler = std::make_unique<Scheduler>(this);
+			m_scheduler->setSpinDuration(m_threadsSpinTime.getValue());
+			m_scheduler->setPipelined(m_pipelinedFrames.getValue() != 0);
+			m_scheduler->setEarlyCutoff(m_earlyCutoff.getValue() != 0);
+			m_scheduler->setFusionThreshold(m_fusionThreshold.getValue());
 			m_scheduler->init(nbThreads);
 		}
 		else
@@ -193,6 +292,18 @@ void PandaDocument::step()
 		object->endStep();
 
 	panda::helper::UpdateLogger::getInstance()->stopLog();
+	helper::resetThreadArenas(); // Nothing allocated during the updates is used anymore
+
+	if (m_memoryTracking)
+	{
+		MemoryFrame frame;
+		frame.time = m_animTimeVal;
+		for (const auto& objectUsage : getMemoryUsage())
+			frame.totalSize += objectUsage.totalSize;
+		if (m_memoryHistory.size() >= maxMemoryFrames) // Drop the oldest half at once
+			m_memoryHistory.erase(m_memoryHistory.begin(), m_memoryHistory.begin() + maxMemoryFrames / 2);
+		m_memoryHistory.push_back(frame);
+	}
 
 	m_signals->timeChanged.run();
 
@@ -240,6 +351,21 @@ void PandaDocument::rewind()
 	m_signals->timeChanged.run();
 }
 
+MemoryUsage PandaDocument::getMemoryUsage() const
+{
+	MemoryUsage usage;
+	addMemoryUsage(usage, const_cast<PandaDocument*>(this));
+	for (const auto& object : m_objectsList->get())
+		addMemoryUsage(usage, object.get());
+	return usage;
+}
+
+void PandaDocument::setMemoryTracking(bool tracking)
+{
+	m_memoryTracking = tracking;
+	m_memoryHistory.clear();
+}
+
 void PandaDocument::updateDocumentData()
 {
 	// First update the value of the document (without modifying the corresponding Data)
@@ -2,6 +2,9 @@
 #define PANDADOCUMENT_H
 
 #include <panda/object/PandaObject.h>
+#include <panda/document/MemoryUsage.h>
+
+#include <functional>
 
 namespace panda {
 
@@ -34,6 +37,10 @@ public:
 
 	uint32_t getNextIndex();
 
+	void assignNodeId(DataNode& node); /// Give a dense index to this node, if it does not already have one (reusing the ones of destroyed nodes)
+	void releaseNodeId(DataNode& node); /// Called when the node is destroyed, its id can be given to another node
+	uint32_t getNodeIdsCount() const; /// All node ids are smaller than this value
+
 	void update() override;
 
 	// When an object is set to laterUpdate, use these functions to help the Scheduler
@@ -41,14 +48,27 @@ public:
 	void setDataReady(BaseData* data) const; // Launch the tasks connected to this node
 	void waitForOtherTasksToFinish(bool mainThread = true) const; // Wait until the tasks we launched finish
 
+	// Data parallelism inside the update of an object (see helper/Parallel.h)
+	void parallelFor(int nbChunks, const std::function<void(int)>& func) const; // Call func for each chunk index, using the threads of the Scheduler if available
+	int getNbParallelThreads() const; // Number of threads that can execute the chunks
+	bool canTakeValue(const BaseData* output) const; // Can the value of this output be moved to its consumer (it will be computed again before being read)
+
 	void onDirtyObject(PandaObject* object);
 	void onModifiedObject(PandaObject* object);
 	void onChangedDock(DockableObject* dockable); // When the dockable has changed dock
+	void onChangedLink(BaseData* data); // When the parent of the data has changed
 
 	gui::BaseGUI& getGUI() const; // Access to the GUI thread, update the view, show message boxes
 	ObjectsList& getObjectsList() const; // Access to the objects, signals when modified
 	DocumentSignals& getSignals() const; // Connect and run signals for when the document is modified
 	UndoStack& getUndoStack() const; // Undo/redo capabilities
+	Scheduler* getScheduler() const; // Can be null if the animation was never run using multiple threads
+
+	// Memory statistics
+	MemoryUsage getMemoryUsage() const; // Memory used by the document and each object (including the ones inside groups), does not update the Datas
+	void setMemoryTracking(bool tracking); // Record the total memory used at the end of each step
+	bool memoryTracking() const;
+	const std::vector<MemoryFrame>& getMemoryHistory() const; // The last steps since the tracking was enabled
 
 	// Slots or called only by the UI
 	void play(bool playing);
@@ -57,20 +77,26 @@ public:
 
 protected:
 	virtual void updateDocumentData(); // At the start of a step
+	bool useScheduler() const; // Are the objects currently updated by the Scheduler
+	void updateWithScheduler(); // Outside of the animation, update the dirty objects using multiple threads
 
 	using ObjectsRawList = std::vector<PandaObject*>;
 	ObjectsRawList m_dirtyObjects; // All the objects that were dirty during the current step
 	uint32_t m_currentIndex;
+	uint32_t m_nextNodeId = 1; // 0 is for nodes not in a document
+	std::vector<uint32_t> m_freeNodeIds; // Ids of the destroyed nodes, declared before the datas of the document as they release their ids when destroyed
 
 	float m_animTimeVal = 0, m_timeStepVal = 0;
 
 	Data<float> m_animTime, m_timestep;
 	Data<int> m_useTimer;
-	Data<int> m_nbThreads;
+	Data<int> m_nbThreads, m_threadsSpinTime, m_pipelinedFrames, m_earlyCutoff;
+	Data<float> m_fusionThreshold;
 
 	bool m_isResetting = false;
 
 	bool m_animPlaying = false, m_animMultithread = false;
+	bool m_schedulerUpdate = false; // Using the Scheduler for a single update, outside of the animation
 	bool m_stepQueued = false, m_stepCanceled = false;
 	int m_animFunctionIndex = -1;
 
@@ -78,6 +104,9 @@ protected:
 	long long m_fpsTime = 0;
 	float m_currentFPS = 0;
 
+	bool m_memoryTracking = false;
+	std::vector<MemoryFrame> m_memoryHistory;
+
 	gui::BaseGUI& m_gui;
 	std::unique_ptr<ObjectsList> m_objectsList;
 	std::unique_ptr<DocumentSignals> m_signals;
@@ -108,6 +137,33 @@ inline bool PandaDocument::animationIsMultithread() const
 inline uint32_t PandaDocument::getNextIndex()
 { return m_currentIndex++; }
 
+inline void PandaDocument::assignNodeId(DataNode& node)
+{
+	if (node.nodeId())
+		return;
+	if (m_freeNodeIds.empty())
+		node.setNodeId(m_nextNodeId++);
+	else
+	{
+		node.setNodeId(m_freeNodeIds.back());
+		m_freeNodeIds.pop_back();
+	}
+}
+
+inline void PandaDocument::releaseNodeId(DataNode& node)
+{
+	if (!node.nodeId())
+		return;
+	m_freeNodeIds.push_back(node.nodeId());
+	node.setNodeId(0);
+}
+
+inline uint32_t PandaDocument::getNodeIdsCount() const
+{ return m_nextNodeId; }
+
+inline bool PandaDocument::useScheduler() const
+{ return m_scheduler && (m_animMultithread || m_schedulerUpdate); }
+
 inline gui::BaseGUI& PandaDocument::getGUI() const
 { return m_gui; }
 
@@ -120,6 +176,15 @@ inline DocumentSignals& PandaDocument::getSignals() const
 inline UndoStack& PandaDocument::getUndoStack() const
 { return *m_undoStack; }
 
+inline Scheduler* PandaDocument::getScheduler() const
+{ return m_scheduler.get(); }
+
+inline bool PandaDocument::memoryTracking() const
+{ return m_memoryTracking; }
+
+inline const std::vector<MemoryFrame>& PandaDocument::getMemoryHistory() const
+{ return m_memoryHistory; }
+
 } // namespace panda
 
 #endif // PANDADOCUMENT_H
@@ -1,11 +1,21 @@
 #include <panda/document/PandaDocument.h>
 #include <panda/helper/UpdateLogger.h>
+#include <panda/document/DocumentSignals.h>
 #include <panda/document/GraphUtils.h>
 #include <panda/document/ObjectsList.h>
 #include <panda/document/Scheduler.h>
+#include <panda/object/Group.h>
+#include <panda/object/Layer.h>
+#include <panda/object/Renderer.h>
+#include <panda/types/DataTraits.h>
 #include <panda/helper/algorithm.h>
+#include <panda/helper/Arena.h>
+#include <panda/helper/SpinLock.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
 #include <thread>
 
 namespace panda
@@ -20,37 +30,96 @@ public:
 	void close();
 	void sleep();
 	void wakeUp();
+	bool unpark(); // Wake up the thread if it is blocked, return false if it was not
 
 	using ThreadPtr = std::shared_ptr<std::thread>;
 	void setThread(ThreadPtr ptr);
 	void joinThread();
 
 	int threadId() const;
+	Scheduler* scheduler() const;
+
+	using SchedulerTask = Scheduler::SchedulerTask;
+	void pushTask(SchedulerTask* task); // Add a ready task to the local queue
+	SchedulerTask* popTask(); // Take the task with the highest priority (also used by the other threads to steal work)
+	bool hasTasks() const; // Can be called without locking
+
+	static SchedulerThread* current(); // The SchedulerThread running on this thread, if any
 
 protected:
 	void idle();
 	void doWork();
+	void waitForTasks(); // Wait inside a step, until there is something to do
+	template <class Pred> void waitUntil(Pred pred); // Spin, then block until pred returns true
+	void requestWakeUp(); // Store the time of the request, used to measure the wake up latency
 
 	Scheduler* m_scheduler;
 	ThreadPtr m_thread;
 	int m_threadId;
 	bool m_mainThread;
 	std::atomic_bool m_closing, m_canSleep, m_mustWakeUp;
+
+	Scheduler::TaskQueue m_tasks;
+
+	std::mutex m_parkMutex;
+	std::condition_variable m_parkCondition;
+	std::atomic_bool m_parked;
+	std::atomic<long long> m_wakeUpRequestTime;
 };
 
+namespace
+{
+	thread_local SchedulerThread* currentSchedulerThread = nullptr;
+
+	struct VisitMarks // Nodes visited by computeConnected, a node is visited if its mark is the current epoch (no need to clear the marks at each search)
+	{
+		uint32_t newEpoch(std::size_t nbNodes)
+		{
+			if(marks.size() < nbNodes)
+				marks.resize(nbNodes, 0);
+			if(!++epoch) // Overflow, the old marks could be taken for the new epoch
+			{
+				std::fill(marks.begin(), marks.end(), 0);
+				epoch = 1;
+			}
+			return epoch;
+		}
+
+		std::vector<uint32_t> marks;
+		uint32_t epoch = 0;
+	};
+	thread_local VisitMarks visitMarks; // Per thread, as the later updates can be prepared by any thread
+
+	long long currentTime()
+	{
+		using namespace std::chrono;
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+}
+
 inline void SchedulerThread::close()
 {
 	m_closing = true; m_mustWakeUp = true; m_canSleep = false;
+	unpark();
 }
 
 inline void SchedulerThread::sleep()
 {
 	m_canSleep = true; m_mustWakeUp = false;
+	unpark();
 }
 
 inline void SchedulerThread::wakeUp()
 {
-	m_mustWakeUp = true;
+	requestWakeUp();
+	m_canSleep = false; m_mustWakeUp = true;
+	unpark();
+}
+
+inline void SchedulerThread::requestWakeUp()
+{
+	long long noRequest = 0; // Keep the first request if there are many
+	m_wakeUpRequestTime.compare_exchange_strong(noRequest, currentTime());
 }
 
 inline void SchedulerThread::setThread(ThreadPtr ptr)
@@ -69,150 +138,217 @@ inline int SchedulerThread::threadId() const
 	return m_threadId;
 }
 
+inline Scheduler* SchedulerThread::scheduler() const
+{
+	return m_scheduler;
+}
+
+inline SchedulerThread* SchedulerThread::current()
+{
+	return currentSchedulerThread;
+}
+
+inline void SchedulerThread::pushTask(SchedulerTask* task)
+{
+	m_tasks.push(task);
+}
+
+inline SchedulerThread::SchedulerTask* SchedulerThread::popTask()
+{
+	return m_tasks.pop();
+}
+
+inline bool SchedulerThread::hasTasks() const
+{
+	return !m_tasks.empty();
+}
+
+inline bool SchedulerThread::unpark()
+{
+	if (!m_parked)
+		return false;
+
+	requestWakeUp();
+	bool parked = true;
+	if (!m_parked.compare_exchange_strong(parked, false))
+		return false;
+	--m_scheduler->m_nbParkedThreads;
+
+	// Taking the lock ensures the thread is either waiting on the condition or has not yet tested m_parked
+	{ std::lock_guard<std::mutex> lock(m_parkMutex); }
+	m_parkCondition.notify_one();
+	return true;
+}
+
 //****************************************************************************//
 
-// It is not used currently as we build the vector all in one go
-//  but we must at least define this constructor as we have an atomic member (non copyable, non movable)
+// We must define these as we have an atomic member (non copyable, non movable)
 Scheduler::SchedulerTask::SchedulerTask(const SchedulerTask& rhs)
+{
+	*this = rhs;
+}
+
+Scheduler::SchedulerTask& Scheduler::SchedulerTask::operator=(const SchedulerTask& rhs)
 {
 	nbDirtyInputs.store(rhs.nbDirtyInputs);
 	nbDirtyAtStart = rhs.nbDirtyAtStart;
 	dirty = rhs.dirty;
 	dirtyAtStart = rhs.dirtyAtStart;
 	restrictToMainThread = rhs.restrictToMainThread;
+	renderStage = rhs.renderStage;
+	cost = rhs.cost;
+	priority = rhs.priority;
+	fusedNext = rhs.fusedNext;
+	nbUpdates = rhs.nbUpdates;
+	nbSkipped = rhs.nbSkipped;
+	savedTime = rhs.savedTime;
 	object = rhs.object;
 	outputs = rhs.outputs;
+	inputs = rhs.inputs;
+	return *this;
+}
+
+bool Scheduler::TaskQueue::lowerPriority(const SchedulerTask* lhs, const SchedulerTask* rhs)
+{
+	return lhs->priority < rhs->priority;
+}
+
+void Scheduler::TaskQueue::push(SchedulerTask* task)
+{
+	std::lock_guard<helper::SpinLock> lock(m_lock);
+	m_heap.push_back(task);
+	std::push_heap(m_heap.begin(), m_heap.end(), lowerPriority);
+	++m_size;
+}
+
+Scheduler::SchedulerTask* Scheduler::TaskQueue::pop()
+{
+	if (!m_size)
+		return nullptr;
+
+	std::lock_guard<helper::SpinLock> lock(m_lock);
+	if (m_heap.empty())
+		return nullptr;
+	std::pop_heap(m_heap.begin(), m_heap.end(), lowerPriority);
+	auto task = m_heap.back();
+	m_heap.pop_back();
+	--m_size;
+	return task;
+}
+
+bool Scheduler::TaskQueue::empty() const
+{
+	return !m_size;
 }
 
 //****************************************************************************//
 
 Scheduler::Scheduler(PandaDocument* document)
 	: m_document(document)
-	, m_readyTasks(256)
-	, m_readyMainTasks(128)
 {
+	m_nbReadyTasks = 0;
+	m_spinDuration = 100;
+	m_nbParkedThreads = 0;
+	m_nbParallelJobs = 0;
+	resetWakeUpStatistics();
+
+	auto& objectsList = m_document->getObjectsList();
+	m_observer.get(objectsList.addedObject).connect<Scheduler, &Scheduler::addedObject>(this);
+	m_observer.get(objectsList.removedObject).connect<Scheduler, &Scheduler::removedObject>(this);
+	m_observer.get(objectsList.clearedList).connect<Scheduler, &Scheduler::clearedList>(this);
+
+	auto& signals = m_document->getSignals();
+	m_observer.get(signals.modifiedObject).connect<Scheduler, &Scheduler::modifiedObject>(this);
+	m_observer.get(signals.changedLink).connect<Scheduler, &Scheduler::changedLink>(this);
 }
 
 void Scheduler::init(int nbThreads)
 {
-	buildDirtyList();
-	buildUpdateGraph();
+	validateGraph();
 
 	prepareThreads(nbThreads);
+
+	// Even if the threads are reused, the logger may have been used by the document with another number of threads
+	helper::UpdateLogger::getInstance()->setNbThreads(static_cast<int>(m_updateThreads.size()));
+	helper::UpdateLogger::getInstance()->setupThread(0);
 }
 
-void Scheduler::stop()
+void Scheduler::validateGraph()
 {
-	if(!m_updateThreads.empty())
-	{
-		for(auto& thread : m_updateThreads)
-			thread->close();
+	if(!m_graphValid)
+		buildUpdateGraph();
 
-		for (auto& thread : m_updateThreads)
-			thread->joinThread();
-
-		m_updateThreads.clear();
+	if(!m_startValuesValid)
+	{
+		computeRenderStage();
+		buildDirtyList();
+		computeStartValues();
+		prepareLaterUpdates();
+		m_startValuesValid = true;
 	}
 }
 
-struct InputsListNode
+void Scheduler::stop()
 {
-	DataNode* node;
-	int distance; // number of nodes between this node and the first node
-	std::vector<int> parentsId;
-};
+	stopThreads();
+	releaseFrozenDatas();
+	propagateTakenValues();
+	m_valueStates.clear(); // Objects can be modified before the next run
+	m_inputStates.clear();
+}
 
-bool containsInput(const std::vector<InputsListNode>& inputsList, int currentNodeId, const DataNode* nextNode)
+void Scheduler::propagateTakenValues()
 {
-	if(currentNodeId < 0 || currentNodeId >= static_cast<int>(inputsList.size()))
-		return false;
-
-	std::deque<int> openSet;
-	openSet.push_back(currentNodeId);
-	while(!openSet.empty())
+	// Without this, a modification of the inputs of the producer would stop at its dirty flag and never reach the consumer
+	for(const auto& task : m_updateTasks)
 	{
-		const InputsListNode& inputNode = inputsList[openSet.front()];
-		openSet.pop_front();
-		if(nextNode == inputNode.node)
-			return true;
+		PandaObject* object = task.object;
+		if(!object || !object->isDirty())
+			continue;
 
-		for(int parentId : inputNode.parentsId)
-			openSet.push_back(parentId);
+		for(DataNode* output : object->getOutputs())
+		{
+			if(output->isDirty())
+				output->setDirtyOutputs();
+			else
+				output->setDirtyValue(object);
+		}
 	}
-
-	return false;
 }
 
 std::vector<DataNode*> Scheduler::computeConnected(const std::vector<DataNode*>& nodes) const
 {
-	std::deque<DataNode*> openSet;
-	std::vector<DataNode*> closedSet;
-	std::vector<InputsListNode> inputsList;
-	std::map<DataNode*, int> indexMap;
+	// Breadth-first search of the outputs, each node is visited only once
+	auto& marks = visitMarks;
+	const uint32_t epoch = marks.newEpoch(m_document->getNodeIdsCount());
 
-	// Initialize the open list with the input nodes
-	for(int i=0, nb=nodes.size(); i<nb; ++i)
-	{
-		DataNode* node = nodes[i];
-		indexMap[node] = i;
-		openSet.push_back(node);
-		InputsListNode iln;
-		iln.node = node;
-		iln.distance = 0;
-		inputsList.push_back(iln);
-	}
+	std::vector<DataNode*> result = nodes;
+	for(auto node : nodes)
+		marks.marks[node->nodeId()] = epoch;
 
-	// Get all the connected nodes
-	while(!openSet.empty())
+	for(std::size_t i = 0; i < result.size(); ++i)
 	{
-		DataNode* node = openSet.front();
-		openSet.pop_front();
-
-		int parentId = indexMap[node];
-		int dist = inputsList[parentId].distance + 1;
-
-		helper::removeOne(closedSet, node);
-		closedSet.push_back(node);
-
-		PandaObject* object = dynamic_cast<PandaObject*>(node);
+		DataNode* node = result[i];
+		PandaObject* object = asObject(node);
 		if(object && object->doesLaterUpdate())
 			continue;
 
 		for(auto output : node->getOutputs())
 		{
-			// We detect when there are loops in the graph
-			if(!containsInput(inputsList, parentId, output))
+			const auto id = output->nodeId();
+			if(!id) // Not in the document, should not happen
 			{
-				// Move the node on the back of the open list
-				helper::removeOne(openSet, output);
-				openSet.push_back(output);
-
-				// If node was already treated, update it
-				if(indexMap.count(output))
-				{
-					InputsListNode& node = inputsList[indexMap[output]];
-					node.distance = dist;
-					if(!helper::contains(node.parentsId, parentId))
-						node.parentsId.push_back(parentId);
-				}
-				else // Create it
-				{
-					int id = inputsList.size();
-					indexMap[output] = id;
-					InputsListNode node;
-					node.node = output;
-					node.distance = dist;
-					node.parentsId.push_back(parentId);
-					inputsList.push_back(node);
-				}
+				if(!helper::contains(result, output))
+					result.push_back(output);
+			}
+			else if(marks.marks[id] != epoch)
+			{
+				marks.marks[id] = epoch;
+				result.push_back(output);
 			}
-//			else
-//				std::cout << "Ignoring node " << getName(output).toStdString() << std::endl;
 		}
 	}
 
-	std::vector<DataNode*> result(closedSet.begin(), closedSet.end());
-
 	// Reverse the list (start from the node furthest from the input nodes)
 	std::reverse(result.begin(), result.end());
 
@@ -232,9 +368,9 @@ std::vector<int> Scheduler::getTasks(const std::vector<DataNode*>& nodes) const
 	std::vector<int> tasks;
 	for(DataNode* node : nodes)
 	{
-		PandaObject* object = dynamic_cast<PandaObject*>(node);
-		if(object)
-			tasks.push_back(m_objectsIndexMap.at(object));
+		int id = taskIndex(node);
+		if(id != -1)
+			tasks.push_back(id);
 	}
 
 	return tasks;
@@ -253,6 +389,17 @@ void Scheduler::buildDirtyList()
 	}
 
 	m_setDirtyList = computeConnected(nodes);
+
+	// In pipelined mode, the nodes of the render stage are set dirty separately
+	m_setDirtyRenderList.clear();
+	if(m_pipelined)
+	{
+		auto it = std::stable_partition(m_setDirtyList.begin(), m_setDirtyList.end(), [this](DataNode* node) {
+			return !isRenderStageNode(node);
+		});
+		m_setDirtyRenderList.assign(it, m_setDirtyList.end());
+		m_setDirtyList.erase(it, m_setDirtyList.end());
+	}
 }
 
 void Scheduler::buildUpdateGraph()
@@ -265,38 +412,22 @@ void Scheduler::buildUpdateGraph()
 	int nb = objects.size();
 	m_updateTasks.clear();
 	m_updateTasks.resize(nb);
+	m_taskIndices.assign(m_document->getNodeIdsCount(), -1);
 	for(int i=0; i<nb; ++i)
 	{
 		PandaObject* object = objects[i];
 		m_updateTasks[i].object = object;
 		if(object->updateOnMainThread())
 			m_updateTasks[i].restrictToMainThread = true;
-		m_objectsIndexMap[object] = i;
+		m_taskIndices[object->nodeId()] = i;
 	}
 
 	// Compute outputs of each object
-	for(auto& task : m_updateTasks)
-	{
-		graph::forEachObjectOutput(task.object, [this, &task](PandaObject* object){
-			if(m_objectsIndexMap.count(object))
-				task.outputs.push_back(m_objectsIndexMap[object]);
-		});
-	}
-
-	// Compute dirty flag and number of dirty inputs for objects at the start of the timestep
-	computeStartValues();
-
-	// Take care of laterUpdate objects
-	m_laterUpdatesMap.clear();
 	for(int i=0; i<nb; ++i)
-	{
-		PandaObject* object = objects[i];
-		if(object->doesLaterUpdate())
-		{
-			for(BaseData* data : object->getOutputDatas())
-				prepareLaterUpdate(data);
-		}
-	}
+		computeTaskOutputs(i);
+
+	m_graphValid = true;
+	m_startValuesValid = false;
 }
 
 void Scheduler::computeStartValues()
@@ -310,16 +441,18 @@ void Scheduler::computeStartValues()
 	// Prepare the number of inputs that are dirty at the start of each time step
 	for(auto node : m_setDirtyList)
 	{
-		PandaObject* object = dynamic_cast<PandaObject*>(node);
-		if(!object || !m_objectsIndexMap.count(object) || object->doesLaterUpdate())
+		PandaObject* object = asObject(node);
+		if(!object || object->doesLaterUpdate())
 			continue;
 
-		m_updateTasks[m_objectsIndexMap[object]].dirtyAtStart = true;
+		int id = taskIndex(object);
+		if(id == -1)
+			continue;
 
-		graph::forEachObjectOutput(object, [this](PandaObject* object){
-			if (m_objectsIndexMap.count(object))
-				++m_updateTasks[m_objectsIndexMap[object]].nbDirtyAtStart;
-		});
+		auto& task = m_updateTasks[id];
+		task.dirtyAtStart = true;
+		for(int output : task.outputs)
+			++m_updateTasks[output].nbDirtyAtStart;
 	}
 
 	for(auto& task : m_updateTasks)
@@ -329,11 +462,217 @@ void Scheduler::computeStartValues()
 	}
 }
 
+void Scheduler::prepareLaterUpdates()
+{
+	m_laterUpdates.clear();
+	m_laterUpdates.resize(m_document->getNodeIdsCount());
+	for(const auto& task : m_updateTasks)
+	{
+		if(task.object->doesLaterUpdate())
+		{
+			for(BaseData* data : task.object->getOutputDatas())
+				prepareLaterUpdate(data);
+		}
+	}
+}
+
+void Scheduler::addedObject(PandaObject* object)
+{
+	releaseFrozenDatas();
+	for(auto newObject : graph::expandObjectsList({ object }))
+		resetNodeStates(newObject);
+	if(!m_graphValid)
+		return;
+
+	m_taskIndices.resize(m_document->getNodeIdsCount(), -1);
+
+	std::vector<int> newTasks;
+	for(auto newObject : graph::expandObjectsList({ object }))
+	{
+		if(taskIndex(newObject) != -1)
+			continue;
+
+		int id = m_updateTasks.size();
+		m_updateTasks.emplace_back();
+		auto& task = m_updateTasks.back();
+		task.object = newObject;
+		task.restrictToMainThread = newObject->updateOnMainThread();
+		m_taskIndices[newObject->nodeId()] = id;
+		newTasks.push_back(id);
+	}
+
+	for(int id : newTasks)
+		updateTaskLinks(id);
+
+	m_startValuesValid = false;
+}
+
+void Scheduler::removedObject(PandaObject* object)
+{
+	releaseFrozenDatas();
+	if(!m_graphValid)
+		return;
+
+	for(auto removedObject : graph::expandObjectsList({ object }))
+		removeTask(removedObject);
+
+	m_startValuesValid = false;
+}
+
+void Scheduler::clearedList()
+{
+	releaseFrozenDatas();
+	m_updateTasks.clear();
+	m_taskIndices.clear();
+	m_setDirtyList.clear();
+	m_laterUpdates.clear();
+	m_startValuesValid = false;
+}
+
+void Scheduler::modifiedObject(PandaObject* object)
+{
+	releaseFrozenDatas();
+	resetNodeStates(object); // It can have new datas
+	if(!m_graphValid)
+		return;
+
+	// Docks are modified when their list of dockables changes
+	int id = taskIndex(object);
+	if(id != -1)
+	{
+		updateTaskLinks(id);
+		m_startValuesValid = false;
+	}
+}
+
+void Scheduler::changedLink(BaseData* data)
+{
+	releaseFrozenDatas();
+	if(!m_graphValid)
+		return;
+
+	m_startValuesValid = false;
+
+	if(!m_inputStates.empty()) // The values of the new parent cannot be compared with the previous ones, forget the states of the datas downstream
+	{
+		const auto dataId = data->nodeId();
+		if(dataId < m_valueStates.size())
+			m_valueStates[dataId] = ValueState();
+		for(auto node : computeConnected(data))
+		{
+			const auto id = node->nodeId();
+			if(id < m_inputStates.size())
+				m_inputStates[id] = InputState();
+		}
+	}
+
+	PandaObject* owner = data->getOwner();
+	int id = owner ? taskIndex(owner) : -1;
+	if(id != -1)
+		updateTaskLinks(id);
+	else if(dynamic_cast<Group*>(owner))
+		m_graphValid = false; // The datas of a group connect objects inside and outside of it, easier to rebuild everything
+}
+
+void Scheduler::resetNodeStates(PandaObject* object)
+{
+	auto resetNode = [this](const DataNode* node) {
+		const auto id = node->nodeId();
+		if(id < m_laterUpdates.size())
+			m_laterUpdates[id] = LaterUpdate();
+		if(id < m_valueStates.size())
+			m_valueStates[id] = ValueState();
+		if(id < m_inputStates.size())
+			m_inputStates[id] = InputState();
+	};
+
+	resetNode(object);
+	for(auto data : object->getDatas())
+		resetNode(data);
+}
+
+void Scheduler::updateTaskLinks(int taskId)
+{
+	// The previous inputs and the current ones can have modified outputs
+	std::vector<int> inputTasks = m_updateTasks[taskId].inputs;
+	graph::forEachObjectInput(m_updateTasks[taskId].object, [this, &inputTasks](PandaObject* object){
+		int id = taskIndex(object);
+		if(id != -1 && !helper::contains(inputTasks, id))
+			inputTasks.push_back(id);
+	});
+
+	computeTaskOutputs(taskId);
+	for(int id : inputTasks)
+		computeTaskOutputs(id);
+}
+
+void Scheduler::computeTaskOutputs(int taskId)
+{
+	for(int output : m_updateTasks[taskId].outputs)
+		helper::removeAll(m_updateTasks[output].inputs, taskId);
+	m_updateTasks[taskId].outputs.clear();
+
+	graph::forEachObjectOutput(m_updateTasks[taskId].object, [this, taskId](PandaObject* object){
+		int id = taskIndex(object);
+		if(id != -1)
+		{
+			m_updateTasks[taskId].outputs.push_back(id);
+			m_updateTasks[id].inputs.push_back(taskId);
+		}
+	});
+}
+
+void Scheduler::removeTask(PandaObject* object)
+{
+	int id = taskIndex(object);
+	if(id == -1)
+		return;
+
+	m_taskIndices[object->nodeId()] = -1;
+
+	const auto& task = m_updateTasks[id];
+	for(int input : task.inputs)
+		helper::removeAll(m_updateTasks[input].outputs, id);
+	for(int output : task.outputs)
+		helper::removeAll(m_updateTasks[output].inputs, id);
+
+	// Move the last task in the free slot so that the indices stay contiguous
+	int lastId = m_updateTasks.size() - 1;
+	if(id != lastId)
+	{
+		auto& movedTask = m_updateTasks[id];
+		movedTask = m_updateTasks[lastId];
+		std::replace(movedTask.inputs.begin(), movedTask.inputs.end(), lastId, id);
+		std::replace(movedTask.outputs.begin(), movedTask.outputs.end(), lastId, id);
+
+		for(int input : movedTask.inputs)
+		{
+			auto& outputs = m_updateTasks[input].outputs;
+			if(input != id)
+				std::replace(outputs.begin(), outputs.end(), lastId, id);
+		}
+		for(int output : movedTask.outputs)
+		{
+			auto& inputs = m_updateTasks[output].inputs;
+			if(output != id)
+				std::replace(inputs.begin(), inputs.end(), lastId, id);
+		}
+
+		m_taskIndices[movedTask.object->nodeId()] = id;
+	}
+
+	m_updateTasks.pop_back();
+}
+
 void Scheduler::prepareThreads(int nbThreads)
 {
 	if(nbThreads < 0)
 		nbThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
 
+	if(static_cast<int>(m_updateThreads.size()) == nbThreads)
+		return; // Already running
+	stopThreads();
+
 	m_updateThreads.push_back(std::make_shared<SchedulerThread>(this, 0));
 	for(int i=1; i<nbThreads; ++i)
 	{
@@ -342,21 +681,44 @@ void Scheduler::prepareThreads(int nbThreads)
 		auto thread = std::make_shared<std::thread>(&SchedulerThread::run, st.get());
 		st->setThread(thread);
 	}
-	
-	helper::UpdateLogger::getInstance()->setNbThreads(nbThreads);
-	helper::UpdateLogger::getInstance()->setupThread(0);
+}
+
+void Scheduler::stopThreads()
+{
+	if(m_updateThreads.empty())
+		return;
+
+	for(auto& thread : m_updateThreads)
+		thread->close();
+
+	for (auto& thread : m_updateThreads)
+		thread->joinThread();
+
+	m_updateThreads.clear();
 }
 
 void Scheduler::setDirty()
 {
+	validateGraph();
+	computePriorities();
+	computeFusedChains();
+
 	{
 		helper::ScopedEvent log("Scheduler/setDirty");
 
+		if(m_pipelined)
+			prepareRenderStage();
+
 		for(DataNode* node : m_setDirtyList)
 			node->doSetDirty(); // Warning: this bypasses PandaObject::setDirtyValue
 
+		if(m_earlyCutoff)
+			prepareEarlyCutoff();
+
 		for(auto& task : m_updateTasks)
 		{
+			if(task.renderStage) // Already prepared
+				continue;
 			task.nbDirtyInputs = task.nbDirtyAtStart;
 			task.dirty = task.dirtyAtStart;
 		}
@@ -369,10 +731,12 @@ void Scheduler::update()
 	helper::ScopedEvent log("Scheduler/update");
 	m_nbReadyTasks = 0;
 
+	// Distribute the first tasks between all threads
+	int threadId = 0, nbThreads = m_updateThreads.size();
 	for(auto& task : m_updateTasks)
 	{
 		if(task.dirty && !task.nbDirtyInputs)
-			readyTask(&task);
+			readyTask(&task, m_updateThreads[threadId++ % nbThreads].get());
 	}
 
 	for(auto& thread : m_updateThreads)
@@ -382,65 +746,125 @@ void Scheduler::update()
 		m_updateThreads[0]->run();
 }
 
+void Scheduler::updateDirtyObjects()
+{
+	if(m_updateThreads.empty())
+		return;
+
+	validateGraph();
+	computePriorities();
+	computeFusedChains();
+	prepareDirtyObjects();
+	update();
+}
+
+void Scheduler::prepareDirtyObjects()
+{
+	helper::ScopedEvent log("Scheduler/prepareDirtyObjects");
+
+	for(auto& task : m_updateTasks)
+	{
+		task.nbDirtyInputs = 0;
+		task.dirty = task.object->isDirty();
+	}
+
+	// Same as computeStartValues, but starting from all the dirty objects instead of the nodes connected to the time
+	for(const auto& task : m_updateTasks)
+	{
+		if(!task.dirty || task.object->doesLaterUpdate())
+			continue;
+
+		for(int output : task.outputs)
+			++m_updateTasks[output].nbDirtyInputs;
+	}
+
+	for(auto& task : m_updateTasks)
+	{
+		if(task.nbDirtyInputs > 0)
+			task.dirty = true;
+	}
+}
+
 void Scheduler::waitForOtherTasks(bool mainThread)
 {
+	auto thread = currentThread();
 	while(m_nbReadyTasks > 1)
 	{
-		while(SchedulerTask* task = getTask(mainThread))
+		while(SchedulerTask* task = getTask(thread, mainThread))
 		{
-			task->dirty = false;
-			task->object->updateIfDirty();
-			finishTask(task);
+			do
+			{
+				runTask(task);
+				task = finishTask(task, thread);
+			} while(task);
 		}
 	}
 }
 
 void Scheduler::prepareLaterUpdate(BaseData* data)
 {
-	auto connected = computeConnected(data);
-
-	std::vector<int> outputsTasks;
+	const auto nodeId = data->nodeId();
+	if(nodeId >= m_laterUpdates.size())
+		m_laterUpdates.resize(m_document->getNodeIdsCount());
+
+	auto& laterUpdate = m_laterUpdates[nodeId];
+	laterUpdate.renderStage = isRenderStageNode(data);
+	laterUpdate.connectedNodes = computeConnected(data);
+	if(m_pipelined && !laterUpdate.renderStage) // The render stage will see the modification at the next step
+	{
+		helper::removeIf(laterUpdate.connectedNodes, [this](DataNode* node) {
+			return isRenderStageNode(node);
+		});
+	}
+	laterUpdate.outputTasks.clear();
 	for(auto output : data->getOutputs())
 	{
-		PandaObject* object = dynamic_cast<PandaObject*>(output);
-		BaseData* data = dynamic_cast<BaseData*>(output);
+		PandaObject* object = asObject(output);
+		BaseData* data = asData(output);
 		if(object)
 		{
-			if (m_objectsIndexMap.count(object))
-				outputsTasks.push_back(m_objectsIndexMap[object]);
+			int id = taskIndex(object);
+			if (id != -1)
+				laterUpdate.outputTasks.push_back(id);
 		}
 		else if(data)
 		{
 			PandaObject* owner = data->getOwner();
-			if (owner && m_objectsIndexMap.count(owner))
-				outputsTasks.push_back(m_objectsIndexMap[owner]);
+			int id = owner ? taskIndex(owner) : -1;
+			if (id != -1)
+				laterUpdate.outputTasks.push_back(id);
 		}
 	}
-
-	m_laterUpdatesMap[data] = std::make_pair(connected, outputsTasks);
+	if(m_pipelined && !laterUpdate.renderStage)
+	{
+		helper::removeIf(laterUpdate.outputTasks, [this](int id) {
+			return m_updateTasks[id].renderStage;
+		});
+	}
+	laterUpdate.prepared = true;
 }
 
 void Scheduler::setDataDirty(BaseData* dirtyData)
 {
 	helper::ScopedEvent log("Scheduler/setDataDirty");
 
-	if (!m_laterUpdatesMap.count(dirtyData))
+	const auto nodeId = dirtyData->nodeId();
+	if (nodeId >= m_laterUpdates.size() || !m_laterUpdates[nodeId].prepared)
 		prepareLaterUpdate(dirtyData);
 
-	const auto& pair = m_laterUpdatesMap[dirtyData];
-	for(auto node : pair.first)
+	const auto& laterUpdate = m_laterUpdates[nodeId];
+	for(auto node : laterUpdate.connectedNodes)
 		node->doSetDirty();
 
 	// For outputs tasks, we still have to do some recursion
-	std::deque<int> openSet;
-	for(auto taskId : pair.second)
-		openSet.push_back(taskId);
-
+	std::vector<int> openSet = laterUpdate.outputTasks;
 	while(!openSet.empty())
 	{
-		int taskId = openSet.front();
-		openSet.pop_front();
+		int taskId = openSet.back();
+		openSet.pop_back();
 		auto& task = m_updateTasks[taskId];
+		if(task.renderStage && !laterUpdate.renderStage)
+			continue;
 		++task.nbDirtyInputs;
 		if(!task.dirty)
 		{
@@ -455,62 +879,657 @@ void Scheduler::setDataReady(BaseData* data)
 {
 	helper::ScopedEvent log("Scheduler/setDataReady");
 
-	if(!m_laterUpdatesMap.count(data))
+	const auto nodeId = data->nodeId();
+	if(nodeId >= m_laterUpdates.size() || !m_laterUpdates[nodeId].prepared)
 		return;
 
-	for(auto taskId : m_laterUpdatesMap[data].second)
+	auto thread = currentThread();
+	for(auto taskId : m_laterUpdates[nodeId].outputTasks)
 	{
 		auto& task = m_updateTasks[taskId];
 		if(task.dirty && !(--task.nbDirtyInputs))
-			readyTask(&task);
+			readyTask(&task, thread);
 	}
 }
 
-Scheduler::SchedulerTask* Scheduler::getTask(bool mainThread)
+Scheduler::SchedulerTask* Scheduler::getTask(SchedulerThread* thread, bool mainThread)
 {
 	Scheduler::SchedulerTask* task;
 	if(mainThread)
 	{
-		if(m_readyMainTasks.pop(task))
+		if((task = m_readyMainTasks.pop()))
 			return task;
 	}
 
-	if(m_readyTasks.pop(task))
+	if((task = thread->popTask()))
 		return task;
 
+	// Local queue is empty, try to steal a task from the other threads
+	int nb = m_updateThreads.size(), id = thread->threadId();
+	for(int i = 1; i < nb; ++i)
+	{
+		if((task = m_updateThreads[(id + i) % nb]->popTask()))
+			return task;
+	}
+
 	return nullptr;
 }
 
-void Scheduler::finishTask(SchedulerTask* task)
+void Scheduler::runTask(SchedulerTask* task)
 {
-	for(auto output : task->outputs)
-	{
-		auto& outputTask = m_updateTasks[output];
-		if(outputTask.dirty && !(--outputTask.nbDirtyInputs))
-			readyTask(&outputTask);
+	task->dirty = false;
+	if(!task->object->isDirty())
+		return;
+
+	if(m_earlyCutoff && !inputsModified(task->object))
+	{ // The outputs already have the values the update would give (they will be cleaned when read)
+		task->object->cleanDirty();
+		++task->nbSkipped;
+		task->savedTime += task->cost;
+		return;
 	}
-	m_nbReadyTasks--;
-}
 
-void Scheduler::readyTask(const SchedulerTask* task)
-{
-	m_nbReadyTasks++;
+	const long long start = currentTime();
+	task->object->updateIfDirty();
+	const float duration = (currentTime() - start) / 1000.f;
+	++task->nbUpdates;
 
-	if(task->restrictToMainThread)
-		m_readyMainTasks.push(task);
-	else
-		m_readyTasks.push(task);
+	if(m_earlyCutoff) // Hashed once here, not by each consumer
+	{
+		for(auto output : task->object->getOutputs())
+		{
+			if(const BaseData* data = asData(output))
+				hashValue(data);
+		}
+	}
+
+	// Exponential moving average, so that the cost can follow the evolution of the document
+	const float weight = 0.2f;
+	task->cost = task->cost > 0 ? (1 - weight) * task->cost + weight * duration : duration;
 }
 
-void Scheduler::testForEnd()
+bool Scheduler::inputsModified(PandaObject* object)
 {
-	if (!m_nbReadyTasks)
+	// Only objects depending solely on the values of their own input datas can be skipped
+	// (not the ones connected to the time of the document or to other objects, nor the ones with an internal state like Buffer)
+	const auto& inputs = object->getInputs();
+	bool modified = inputs.empty() || object->doesLaterUpdate();
+	for(auto input : inputs)
 	{
-		for(auto& thread : m_updateThreads)
+		const BaseData* data = asData(input);
+		const auto id = input->nodeId();
+		if(!data || data->getOwner() != object || !id || id >= m_inputStates.size())
+		{
+			modified = true;
+			continue;
+		}
+
+		// Look at all inputs to keep their states up to date
+		data->getVoidValue(); // Also updates the data and its parents
+		const BaseData* source = data->getCounterSource();
+		const auto sourceId = source->nodeId();
+		auto& state = m_inputStates[id];
+		if(!sourceId || sourceId >= m_valueStates.size() || m_valueStates[sourceId].counter != source->getCounter())
+		{ // Not hashed since its last modification
+			state = InputState();
+			modified = true;
+			continue;
+		}
+
+		const auto& value = m_valueStates[sourceId];
+		if(state.source != sourceId || state.version != value.version) // Relinked, or a different value
+			modified = true;
+		state.source = sourceId;
+		state.version = value.version;
+	}
+
+	return modified;
+}
+
+void Scheduler::prepareEarlyCutoff()
+{
+	const auto nbNodes = m_document->getNodeIdsCount();
+	m_valueStates.resize(nbNodes);
+	m_inputStates.resize(nbNodes);
+
+	// The outputs of the tasks are hashed after their update, here we look at the values modified between two steps
+	for(const auto& task : m_updateTasks)
+	{
+		for(auto input : task.object->getInputs())
+		{
+			const BaseData* data = asData(input);
+			if(!data)
+				continue;
+
+			const BaseData* source = data->getCounterSource();
+			if(!source->isDirty()) // Else it will be updated by a task during this step
+				hashValue(source);
+		}
+	}
+}
+
+void Scheduler::hashValue(const BaseData* data)
+{
+	const auto id = data->nodeId();
+	if(!id || id >= m_valueStates.size())
+		return;
+
+	const void* value = data->getVoidValue(); // Before reading the counter, this can update the data
+	auto& state = m_valueStates[id];
+	const int counter = data->getCounter();
+	if(counter == state.counter)
+		return;
+
+	std::size_t hash = 0;
+	const bool hashed = data->getDataTrait()->hashValue(value, hash);
+	if(!hashed || !state.hashed || hash != state.hash)
+		++state.version;
+	state.counter = counter;
+	state.hashed = hashed;
+	state.hash = hash;
+}
+
+void Scheduler::computePriorities()
+{
+	helper::ScopedEvent log("Scheduler/computePriorities");
+
+	// Depth-first traversal, computing the bottom level of a task after the ones of its outputs
+	// Edges going back to a task being visited are part of a loop, and are ignored
+	enum VisitState : char { NotVisited, Visiting, Visited };
+	const int nb = m_updateTasks.size();
+	std::vector<VisitState> states(nb, NotVisited);
+	std::vector<std::pair<int, int>> stack; // Task index and index of the next output to visit
+	for(int i = 0; i < nb; ++i)
+	{
+		if(states[i] != NotVisited)
+			continue;
+
+		states[i] = Visiting;
+		stack.emplace_back(i, 0);
+		while(!stack.empty())
+		{
+			auto& top = stack.back();
+			auto& task = m_updateTasks[top.first];
+			if(top.second < static_cast<int>(task.outputs.size()))
+			{
+				int output = task.outputs[top.second++];
+				if(states[output] == NotVisited)
+				{
+					states[output] = Visiting;
+					stack.emplace_back(output, 0);
+				}
+				continue;
+			}
+
+			float maxOutput = 0;
+			for(int output : task.outputs)
+			{
+				if(states[output] == Visited)
+					maxOutput = std::max(maxOutput, m_updateTasks[output].priority);
+			}
+
+			// Tasks never updated count as 1 microsecond
+			task.priority = (task.cost > 0 ? task.cost : 1.f) + maxOutput;
+			states[top.first] = Visited;
+			stack.pop_back();
+		}
+	}
+}
+
+Scheduler::SchedulerTask* Scheduler::finishTask(SchedulerTask* task, SchedulerThread* thread)
+{
+	if(task->fusedNext != -1)
+	{ // This task is the only input of the next one: it can be run directly, taking the place of this one in m_nbReadyTasks
+		auto& nextTask = m_updateTasks[task->fusedNext];
+		if(nextTask.dirty && !(--nextTask.nbDirtyInputs))
+			return &nextTask;
+	}
+	else
+	{
+		for(auto output : task->outputs)
+		{
+			auto& outputTask = m_updateTasks[output];
+			if(outputTask.renderStage && !task->renderStage) // Not counted in pipelined mode
+				continue;
+			if(outputTask.dirty && !(--outputTask.nbDirtyInputs))
+				readyTask(&outputTask, thread);
+		}
+	}
+
+	// The main thread must test for the end of the step
+	if(!--m_nbReadyTasks)
+		m_updateThreads[0]->unpark();
+	return nullptr;
+}
+
+void Scheduler::computeFusedChains()
+{
+	for(auto& task : m_updateTasks)
+		task.fusedNext = -1;
+
+	if(m_fusionThreshold <= 0)
+		return;
+
+	// Tasks never updated are not fused, as we do not know their cost yet
+	auto isCheap = [this](const SchedulerTask& task) {
+		return task.cost > 0 && task.cost < m_fusionThreshold && !task.object->doesLaterUpdate();
+	};
+
+	for(int i = 0, nb = m_updateTasks.size(); i < nb; ++i)
+	{
+		auto& task = m_updateTasks[i];
+		if(task.outputs.size() != 1 || !isCheap(task))
+			continue;
+
+		const int next = task.outputs.front();
+		const auto& nextTask = m_updateTasks[next];
+		if(next == i || nextTask.inputs.size() != 1 || !isCheap(nextTask)
+			|| nextTask.restrictToMainThread != task.restrictToMainThread
+			|| nextTask.renderStage != task.renderStage)
+			continue;
+
+		task.fusedNext = next;
+	}
+}
+
+void Scheduler::readyTask(SchedulerTask* task, SchedulerThread* thread)
+{
+	m_nbReadyTasks++;
+
+	if(task->restrictToMainThread)
+	{
+		m_readyMainTasks.push(task);
+		m_updateThreads[0]->unpark();
+	}
+	else
+	{
+		thread->pushTask(task);
+
+		// Wake up one blocked thread so that it can steal this task
+		if(m_nbParkedThreads > 0)
+		{
+			for(auto& other : m_updateThreads)
+			{
+				if(other.get() != thread && other->unpark())
+					break;
+			}
+		}
+	}
+}
+
+int Scheduler::taskIndex(const DataNode* node) const
+{
+	const auto id = node->nodeId();
+	return id < m_taskIndices.size() ? m_taskIndices[id] : -1;
+}
+
+SchedulerThread* Scheduler::currentThread() const
+{
+	auto thread = SchedulerThread::current();
+	if(thread && thread->scheduler() == this)
+		return thread;
+	return m_updateThreads[0].get();
+}
+
+bool Scheduler::hasReadyTasks(bool mainThread) const
+{
+	if(mainThread && !m_readyMainTasks.empty())
+		return true;
+
+	for(const auto& thread : m_updateThreads)
+	{
+		if(thread->hasTasks())
+			return true;
+	}
+
+	return false;
+}
+
+void Scheduler::setPipelined(bool pipelined)
+{
+	if(m_pipelined == pipelined)
+		return;
+
+	releaseFrozenDatas();
+	m_pipelined = pipelined;
+	m_startValuesValid = false;
+}
+
+bool Scheduler::isPipelined() const
+{
+	return m_pipelined;
+}
+
+void Scheduler::setFusionThreshold(float microseconds)
+{
+	m_fusionThreshold = microseconds;
+}
+
+float Scheduler::fusionThreshold() const
+{
+	return m_fusionThreshold;
+}
+
+void Scheduler::setEarlyCutoff(bool cutoff)
+{
+	m_earlyCutoff = cutoff;
+	m_valueStates.clear();
+	m_inputStates.clear();
+}
+
+bool Scheduler::hasEarlyCutoff() const
+{
+	return m_earlyCutoff;
+}
+
+bool Scheduler::canTakeValue(const BaseData* output) const
+{
+	if(m_earlyCutoff) // A skipped object must keep the values of its outputs
+		return false;
+
+	PandaObject* object = output->getOwner();
+	int id = object ? taskIndex(object) : -1;
+	if(id == -1 || object->doesLaterUpdate())
+		return false;
+
+	// The object must be updated at the start of every step, and not with the frozen values of the render stage
+	const auto& task = m_updateTasks[id];
+	return task.dirtyAtStart && !task.renderStage;
+}
+
+std::vector<Scheduler::CutoffStatistics> Scheduler::cutoffStatistics() const
+{
+	std::vector<CutoffStatistics> statistics;
+	for(const auto& task : m_updateTasks)
+	{
+		if(!task.nbUpdates && !task.nbSkipped)
+			continue;
+
+		CutoffStatistics stats;
+		stats.object = task.object;
+		stats.nbUpdates = task.nbUpdates;
+		stats.nbSkipped = task.nbSkipped;
+		stats.savedTime = task.savedTime;
+		statistics.push_back(stats);
+	}
+
+	// The objects that saved the most time first
+	std::sort(statistics.begin(), statistics.end(), [](const CutoffStatistics& lhs, const CutoffStatistics& rhs) {
+		return lhs.savedTime > rhs.savedTime;
+	});
+	return statistics;
+}
+
+void Scheduler::resetCutoffStatistics()
+{
+	for(auto& task : m_updateTasks)
+	{
+		task.nbUpdates = task.nbSkipped = 0;
+		task.savedTime = 0;
+	}
+}
+
+void Scheduler::computeRenderStage()
+{
+	m_renderStageInputs.clear();
+	for(auto& task : m_updateTasks)
+		task.renderStage = false;
+	if(!m_pipelined)
+		return;
+
+	// The layers and the renderers, then all the tasks connected to their outputs
+	std::vector<int> openList;
+	for(int i = 0, nb = m_updateTasks.size(); i < nb; ++i)
+	{
+		auto object = m_updateTasks[i].object;
+		if(dynamic_cast<BaseLayer*>(object) || dynamic_cast<Renderer*>(object))
+			openList.push_back(i);
+	}
+
+	while(!openList.empty())
+	{
+		int id = openList.back();
+		openList.pop_back();
+		auto& task = m_updateTasks[id];
+		if(task.renderStage)
+			continue;
+		task.renderStage = true;
+
+		for(int output : task.outputs)
+			openList.push_back(output);
+
+		// Objects directly connected to this one (not using a data) cannot be separated from it
+		for(auto input : task.object->getInputs())
+		{
+			PandaObject* object = asObject(input);
+			int inputId = object ? taskIndex(object) : -1;
+			if(inputId != -1)
+				openList.push_back(inputId);
+		}
+	}
+
+	// The datas that will be frozen at each step
+	for(const auto& task : m_updateTasks)
+	{
+		if(!task.renderStage)
+			continue;
+
+		for(BaseData* data : task.object->getInputDatas())
+		{
+			BaseData* parent = data->getParent();
+			if(parent && !isRenderStageNode(parent))
+				m_renderStageInputs.push_back(data);
+		}
+	}
+}
+
+bool Scheduler::isRenderStageNode(const DataNode* node) const
+{
+	const PandaObject* object = asObject(node);
+	const BaseData* data = asData(node);
+	while(data)
+	{
+		object = data->getOwner();
+		if(!object || taskIndex(object) != -1 || !data->getParent())
+			break;
+		data = data->getParent(); // The data of a group, use the object it is connected to
+	}
+
+	if(!object)
+		return false;
+
+	int id = taskIndex(object);
+	if(id != -1)
+		return m_updateTasks[id].renderStage;
+	return m_pipelined && dynamic_cast<const BaseLayer*>(object); // The default layer is not a task
+}
+
+void Scheduler::prepareRenderStage()
+{
+	// The modifications done by the compute stage during the previous step are now visible to the render stage
+	releaseFrozenDatas();
+	for(DataNode* node : m_setDirtyRenderList)
+		node->doSetDirty();
+
+	// Until the next step, the render stage uses a copy of these values
+	for(BaseData* data : m_renderStageInputs)
+		data->freeze();
+	m_frozenDatas = m_renderStageInputs;
+
+	for(auto& task : m_updateTasks)
+	{
+		if(task.renderStage)
+			task.dirty = task.object->isDirty();
+	}
+
+	// The inputs from the compute stage are already up to date
+	for(auto& task : m_updateTasks)
+	{
+		if(!task.renderStage)
+			continue;
+
+		int nbDirtyInputs = 0;
+		for(int input : task.inputs)
+		{
+			const auto& inputTask = m_updateTasks[input];
+			if(inputTask.renderStage && inputTask.dirty && !inputTask.object->doesLaterUpdate())
+				++nbDirtyInputs;
+		}
+		task.nbDirtyInputs = nbDirtyInputs;
+	}
+}
+
+void Scheduler::releaseFrozenDatas()
+{
+	for(BaseData* data : m_frozenDatas)
+		data->unfreeze();
+	m_frozenDatas.clear();
+}
+
+void Scheduler::setSpinDuration(int microseconds)
+{
+	m_spinDuration = microseconds;
+}
+
+int Scheduler::spinDuration() const
+{
+	return m_spinDuration;
+}
+
+void Scheduler::recordWakeUp(long long latency, bool blocked)
+{
+	++m_nbWakeUps;
+	if(blocked)
+		++m_nbBlockedWakeUps;
+	m_wakeUpLatencySum += latency;
+
+	long long prevMax = m_wakeUpLatencyMax;
+	while(prevMax < latency && !m_wakeUpLatencyMax.compare_exchange_weak(prevMax, latency));
+}
+
+Scheduler::WakeUpStatistics Scheduler::wakeUpStatistics() const
+{
+	WakeUpStatistics stats;
+	stats.nbWakeUps = m_nbWakeUps;
+	stats.nbBlocked = m_nbBlockedWakeUps;
+	if(stats.nbWakeUps)
+		stats.meanLatency = m_wakeUpLatencySum / (stats.nbWakeUps * 1000.0);
+	stats.maxLatency = m_wakeUpLatencyMax / 1000.0;
+	return stats;
+}
+
+void Scheduler::resetWakeUpStatistics()
+{
+	m_nbWakeUps = 0;
+	m_nbBlockedWakeUps = 0;
+	m_wakeUpLatencySum = 0;
+	m_wakeUpLatencyMax = 0;
+}
+
+void Scheduler::testForEnd()
+{
+	if (!m_nbReadyTasks)
+	{
+		for(auto& thread : m_updateThreads)
 			thread->sleep();
 	}
 }
 
+int Scheduler::nbThreads() const
+{
+	return std::max<int>(1, m_updateThreads.size());
+}
+
+void Scheduler::parallelFor(int nbChunks, const ChunkFunctor& func)
+{
+	if(nbChunks <= 0)
+		return;
+
+	ParallelJob job(nbChunks, func);
+	if(nbChunks > 1 && m_updateThreads.size() > 1)
+	{
+		{
+			std::lock_guard<helper::SpinLock> lock(m_parallelJobsLock);
+			m_parallelJobs.push_back(&job);
+			++m_nbParallelJobs;
+		}
+
+		// Blocked threads will not see the job otherwise
+		auto current = currentThread();
+		int nbToWake = nbChunks - 1;
+		for(auto& thread : m_updateThreads)
+		{
+			if(nbToWake <= 0 || !m_nbParkedThreads)
+				break;
+			if(thread.get() != current && thread->unpark())
+				--nbToWake;
+		}
+	}
+
+	job.execute();
+
+	// No other thread can take this job now, but we have to wait for the helpers still executing a chunk
+	{
+		std::lock_guard<helper::SpinLock> lock(m_parallelJobsLock);
+		auto it = std::find(m_parallelJobs.begin(), m_parallelJobs.end(), &job);
+		if(it != m_parallelJobs.end())
+		{
+			m_parallelJobs.erase(it);
+			--m_nbParallelJobs;
+		}
+	}
+
+	while(job.nbHelpers)
+		std::this_thread::yield();
+}
+
+void Scheduler::ParallelJob::execute()
+{
+	int chunk;
+	while((chunk = nextChunk++) < nbChunks)
+	{
+		helper::ArenaScope arenaScope; // The temporaries of the chunk (this thread may not be in an update)
+		func(chunk);
+	}
+}
+
+bool Scheduler::helpParallelJob()
+{
+	if(!m_nbParallelJobs)
+		return false;
+
+	ParallelJob* job = nullptr;
+	{
+		std::lock_guard<helper::SpinLock> lock(m_parallelJobsLock);
+		while(!m_parallelJobs.empty())
+		{
+			job = m_parallelJobs.back();
+			if(job->nextChunk < job->nbChunks)
+			{
+				++job->nbHelpers; // The job cannot be destroyed until we release it
+				break;
+			}
+
+			// All the chunks are taken, no need to look at this job again
+			m_parallelJobs.pop_back();
+			--m_nbParallelJobs;
+			job = nullptr;
+		}
+	}
+
+	if(!job)
+		return false;
+
+	job->execute();
+	--job->nbHelpers;
+	return true;
+}
+
+bool Scheduler::hasParallelJobs() const
+{
+	return m_nbParallelJobs > 0;
+}
+
 //****************************************************************************//
 
 SchedulerThread::SchedulerThread(Scheduler* scheduler, int threadId)
@@ -521,12 +1540,22 @@ SchedulerThread::SchedulerThread(Scheduler* scheduler, int threadId)
 	m_closing = false;
 	m_canSleep = false;
 	m_mustWakeUp = false;
+	m_parked = false;
+	m_wakeUpRequestTime = 0;
 }
 
 void SchedulerThread::run()
 {
 	helper::UpdateLogger::getInstance()->setupThread(m_threadId);
 
+	// The main thread only runs during Scheduler::update
+	struct CurrentThreadSetter
+	{
+		CurrentThreadSetter(SchedulerThread* thread) : previous(currentSchedulerThread) { currentSchedulerThread = thread; }
+		~CurrentThreadSetter() { currentSchedulerThread = previous; }
+		SchedulerThread* previous;
+	} currentSetter(this);
+
 	while(!m_closing)
 	{
 		if(!m_mainThread)
@@ -552,25 +1581,79 @@ void SchedulerThread::run()
 
 			if (m_closing)
 				return;
+
+			waitForTasks();
 		}
 	}
 }
 
+template <class Pred>
+void SchedulerThread::waitUntil(Pred pred)
+{
+	const long long startTime = currentTime();
+	const int spinDuration = m_scheduler->spinDuration();
+	const long long spinEnd = startTime + spinDuration * 1000LL;
+	bool blocked = false;
+
+	while (!pred())
+	{
+		if (spinDuration < 0 || currentTime() < spinEnd)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Spinned long enough, block the thread until another one calls unpark
+		std::unique_lock<std::mutex> lock(m_parkMutex);
+		m_parked = true;
+		++m_scheduler->m_nbParkedThreads;
+		while (m_parked && !pred())
+			m_parkCondition.wait(lock);
+		if (m_parked.exchange(false))
+			--m_scheduler->m_nbParkedThreads;
+		blocked = true;
+	}
+
+	const long long requestTime = m_wakeUpRequestTime.exchange(0);
+	if (requestTime >= startTime)
+		m_scheduler->recordWakeUp(currentTime() - requestTime, blocked);
+}
+
 void SchedulerThread::idle()
 {
-	while (!m_mustWakeUp)
-		std::this_thread::yield();
+	waitUntil([this] { return m_mustWakeUp.load(); });
 
 	m_mustWakeUp = false;
 }
 
+void SchedulerThread::waitForTasks()
+{
+	helper::ScopedEvent log("Scheduler/wait"); // Time spent by this thread without a task during a step
+	waitUntil([this] {
+		return m_canSleep || m_closing
+			|| m_scheduler->hasReadyTasks(m_mainThread)
+			|| m_scheduler->hasParallelJobs()
+			|| (m_mainThread && !m_scheduler->m_nbReadyTasks); // The main thread tests for the end of the step
+	});
+}
+
 void SchedulerThread::doWork()
 {
-	while(Scheduler::SchedulerTask* task = m_scheduler->getTask(m_mainThread))
+	while(true)
 	{
-		task->dirty = false;
-		task->object->updateIfDirty();
-		m_scheduler->finishTask(task);
+		// Help the tasks waiting for their parallel loops first, as they are already running
+		if(m_scheduler->helpParallelJob())
+			continue;
+
+		Scheduler::SchedulerTask* task = m_scheduler->getTask(this, m_mainThread);
+		if(!task)
+			break;
+
+		do
+		{
+			m_scheduler->runTask(task);
+			task = m_scheduler->finishTask(task, this);
+		} while(task);
 	}
 }
 
@@ -2,6 +2,8 @@
 #define SCHEDULER_H
 
 #include <panda/core.h>
+#include <panda/messaging.h>
+#include <panda/helper/SpinLock.h>
 
 #ifdef _MSC_VER
 #define _ENABLE_ATOMIC_ALIGNMENT_FIX
@@ -15,11 +17,8 @@
 
 #include <functional>
 #include <memory>
-#include <map>
 #include <vector>
 
-#include <boost/lockfree/queue.hpp>
-
 namespace panda
 {
 
@@ -33,30 +32,111 @@ class PANDA_CORE_API Scheduler
 {
 public:
 	Scheduler(PandaDocument* document);
-	void init(int nbThreads = -1); // If -1, use half of hardware concurrency
+	void init(int nbThreads = -1); // If -1, use half of hardware concurrency. The graph is only completely built the first time, the threads are kept if their number does not change.
 	void stop();
 
 	void setDirty();
 	void update();
+	void updateDirtyObjects(); // Update all the objects that are dirty, outside of the animation (init must have been called)
 	void waitForOtherTasks(bool mainThread); // Work until there is only 1 task running (useful for the Replicator)
 
 	void setDataDirty(BaseData* data); // Set the outputs to dirty before setting the value (so it doesn't propagate)
 	void setDataReady(BaseData* data); // Launch the tasks connected to this node
 
+	void setPipelined(bool pipelined); // Compute the next step while rendering the current one (must be called when not running)
+	bool isPipelined() const;
+
+	void setEarlyCutoff(bool cutoff); // Do not update an object if the values of its inputs did not change since its last update
+	bool hasEarlyCutoff() const;
+
+	struct CutoffStatistics
+	{
+		PandaObject* object = nullptr;
+		long long nbUpdates = 0, nbSkipped = 0; // Number of times the object was updated, and number of updates avoided
+		double savedTime = 0; // Estimation of the time saved by the avoided updates (in microseconds)
+	};
+	std::vector<CutoffStatistics> cutoffStatistics() const;
+	void resetCutoffStatistics();
+
+	bool canTakeValue(const BaseData* output) const; // Is the owner of this output updated at each step, before any other read of this output
+
+	void setFusionThreshold(float microseconds); // Linear chains of objects cheaper than this are run by the same thread without going through the queues (0 to disable)
+	float fusionThreshold() const;
+
+	void setSpinDuration(int microseconds); // Time an idle thread spins before blocking (0 to block immediately, -1 to never block)
+	int spinDuration() const;
+
+	struct WakeUpStatistics
+	{
+		long long nbWakeUps = 0, nbBlocked = 0; // Number of times an idle thread was woken up, and how many times it was blocked
+		double meanLatency = 0, maxLatency = 0; // Time between the wake up request and the thread running again (in microseconds)
+	};
+	WakeUpStatistics wakeUpStatistics() const;
+	void resetWakeUpStatistics();
+
+	using ChunkFunctor = std::function<void(int)>;
+	void parallelFor(int nbChunks, const ChunkFunctor& func); // Call func for each chunk index, helped by the idle threads. Returns when all chunks are done.
+	int nbThreads() const;
+
 protected:
 	void buildDirtyList();
 	void buildUpdateGraph();
 	void computeStartValues();
+	void prepareLaterUpdates();
 	void prepareThreads(int nbThreads = -1);
+	void stopThreads();
+	void prepareDirtyObjects(); // Set the tasks dirty from the state of their objects
+	void validateGraph(); // Rebuild what was invalidated by the modifications of the document
+
+	// Pipelined mode: the render stage (layers, renderers and their outputs) of a step runs at the same time as the compute stage (all other tasks) of the next one
+	void computeRenderStage();
+	void prepareRenderStage(); // Freeze the inputs of the render stage and compute its dirty tasks
+	void releaseFrozenDatas();
+	void propagateTakenValues(); // Producers whose value was taken are dirty but did not propagate it (see canTakeValue), do it when the animation stops
+	bool isRenderStageNode(const DataNode* node) const;
+
+	// Incremental modifications of the graph, connected to the signals of the document
+	void addedObject(PandaObject* object);
+	void removedObject(PandaObject* object);
+	void clearedList();
+	void modifiedObject(PandaObject* object);
+	void changedLink(BaseData* data);
+	void resetNodeStates(PandaObject* object); // The ids of destroyed nodes are reused, forget what was stored for the previous owners of the ids of this object and its datas
+
+	void updateTaskLinks(int taskId); // Recompute the connections of this task and of the tasks connected to its inputs
+	void computeTaskOutputs(int taskId);
+	void removeTask(PandaObject* object);
+	int taskIndex(const DataNode* node) const; // Index of the task of this object, or -1
 
 	friend class SchedulerThread;
 	struct SchedulerTask;
-	SchedulerTask* getTask(bool mainThread); // Get the next ready task
-	void finishTask(SchedulerTask* task); // Call by a thread when a task is finished
-	void readyTask(const SchedulerTask* task); // Add the task to the ready queue
+	SchedulerTask* getTask(SchedulerThread* thread, bool mainThread); // Get the next ready task, from the local queue or by stealing from another thread
+	SchedulerTask* finishTask(SchedulerTask* task, SchedulerThread* thread); // Call by a thread when a task is finished, returns the next task of its chain if it must be run directly
+	void readyTask(SchedulerTask* task, SchedulerThread* thread); // Add the task to the ready queue of this thread (or to the main thread queue if restricted)
 	void testForEnd();
+	SchedulerThread* currentThread() const; // The SchedulerThread executing the caller, or the main one if called from outside
+	bool hasReadyTasks(bool mainThread) const; // Is there a task this thread could take
+	void recordWakeUp(long long latency, bool blocked); // Latency in nanoseconds
+	void runTask(SchedulerTask* task); // Update the object and measure its cost
+	bool inputsModified(PandaObject* object); // Compare the values of the inputs with the ones of the last update (early cutoff)
+	void prepareEarlyCutoff(); // Hash the values modified outside of the tasks (time, values set in the UI)
+	void hashValue(const BaseData* data); // Hash the value of this data if it was modified since the last time
+	void computePriorities();
+	void computeFusedChains(); // Link the cheap tasks that have only one input and one output task
+
+	struct ParallelJob // Chunks of a parallelFor, executed by the calling thread and the threads helping it
+	{
+		ParallelJob(int nbChunks, const ChunkFunctor& func) : nbChunks(nbChunks), func(func) { nextChunk = 0; nbHelpers = 0; }
+		void execute(); // Take and execute chunks until there is none left
+
+		const int nbChunks;
+		const ChunkFunctor& func;
+		std::atomic_int nextChunk, nbHelpers;
+	};
+	bool helpParallelJob(); // Execute chunks of the last pending job, return false if there was none
+	bool hasParallelJobs() const;
 
-	std::vector<DataNode*> computeConnected(const std::vector<DataNode*>& nodes) const; // Get the outputs of the nodes, sorted by distance
+	std::vector<DataNode*> computeConnected(const std::vector<DataNode*>& nodes) const; // Get the nodes connected to the outputs of these nodes, the furthest first
 	std::vector<DataNode*> computeConnected(DataNode* node) const;
 	std::vector<int> getTasks(const std::vector<DataNode*>& nodes) const;
 	void prepareLaterUpdate(BaseData* data);
@@ -65,26 +145,88 @@ protected:
 	{
 		SchedulerTask() { nbDirtyInputs = 0; }
 		SchedulerTask(const SchedulerTask&);
+		SchedulerTask& operator=(const SchedulerTask&);
 		std::atomic_int nbDirtyInputs; // When this equal 0 (and is dirty), we can update the object
 		int nbDirtyAtStart = 0; // Value of nbDirtyInputs at the start of the timestep
 		bool dirty = false; // First this has to become true to update the object
 		bool dirtyAtStart = false; // Value of dirty at the start of the timestep
 		bool restrictToMainThread = false; // For Objects that use OpenGL, update them only on the main thread
+		bool renderStage = false; // In pipelined mode, is this task updated with the frozen values of the previous step
+		float cost = 0; // Moving average of the duration of the object's update (in microseconds)
+		float priority = 0; // Bottom level: cost of the longest path from this task to the end of the graph
+		int fusedNext = -1; // Next task of a chain of cheap objects, run by the same thread directly after this one
+		long long nbUpdates = 0, nbSkipped = 0; // Early cutoff statistics
+		double savedTime = 0;
 		PandaObject* object = nullptr; // Object concerned by this task
 		std::vector<int> outputs; // Indices of other SchedulerTasks	
+		std::vector<int> inputs; // Reverse of the outputs lists, used to patch the graph
+	};
+
+	class TaskQueue // Ready tasks, sorted by priority
+	{
+	public:
+		TaskQueue() { m_size = 0; }
+		void push(SchedulerTask* task);
+		SchedulerTask* pop(); // Take the task with the highest priority, or null if empty
+		bool empty() const; // Can be called without locking
+
+	protected:
+		static bool lowerPriority(const SchedulerTask* lhs, const SchedulerTask* rhs);
+
+		helper::SpinLock m_lock;
+		std::vector<SchedulerTask*> m_heap;
+		std::atomic_int m_size;
 	};
 
 	PandaDocument* m_document;
 	std::vector<DataNode*> m_setDirtyList; // At each step, all these nodes will always be dirty (connected to the mouse position or the animation time)
-	std::map< BaseData*, std::pair<std::vector<DataNode*>, std::vector<int> > > m_laterUpdatesMap; // For nodes that will get dirty later (like Buffer or Replicator)
+
+	struct LaterUpdate // For nodes that will get dirty later (like Buffer or Replicator)
+	{
+		bool prepared = false;
+		bool renderStage = false; // If not, the tasks of the render stage are not modified
+		std::vector<DataNode*> connectedNodes; // Will be set dirty with the data
+		std::vector<int> outputTasks; // Tasks directly connected to the data
+	};
+	std::vector<LaterUpdate> m_laterUpdates; // Indexed by the node id of the data
 
 	std::vector<SchedulerTask> m_updateTasks;
-	std::map<PandaObject*, int> m_objectsIndexMap;
+	std::vector<int> m_taskIndices; // Index of the task for each node id, -1 if it is not an object in the graph
+	bool m_graphValid = false, m_startValuesValid = false;
+
+	bool m_pipelined = false;
+	std::vector<DataNode*> m_setDirtyRenderList; // Part of m_setDirtyList in the render stage, set dirty when the frozen values are updated
+	std::vector<BaseData*> m_renderStageInputs, m_frozenDatas; // Datas of the render stage connected to the compute stage
+	msg::Observer m_observer;
+
+	struct ValueState // Hash of a data providing the value of inputs (an output, or a data not linked), computed once after each modification
+	{
+		int counter = -1;
+		bool hashed = false; // If false, the value cannot be compared
+		std::size_t hash = 0;
+		unsigned int version = 0; // Incremented when the hash changes
+	};
+	struct InputState // Value of an input data at the last update of its owner
+	{
+		uint32_t source = 0; // Node id of the data providing the value (see BaseData::getCounterSource)
+		unsigned int version = 0;
+	};
+	bool m_earlyCutoff = false;
+	std::vector<ValueState> m_valueStates; // Indexed by the node id of the data
+	std::vector<InputState> m_inputStates; // Indexed by the node id of the data
 
 	std::vector<std::shared_ptr<SchedulerThread>> m_updateThreads;
 
-	boost::lockfree::queue<const SchedulerTask*> m_readyTasks, m_readyMainTasks;
+	TaskQueue m_readyMainTasks; // The other tasks are in the queues of each thread
 	std::atomic_int m_nbReadyTasks;
+
+	helper::SpinLock m_parallelJobsLock;
+	std::vector<ParallelJob*> m_parallelJobs; // Jobs that still have chunks not taken by a thread, the most nested last
+	std::atomic_int m_nbParallelJobs;
+
+	float m_fusionThreshold = 0;
+	std::atomic_int m_spinDuration, m_nbParkedThreads;
+	std::atomic<long long> m_nbWakeUps, m_nbBlockedWakeUps, m_wakeUpLatencySum, m_wakeUpLatencyMax;
 };
 
 } // namespace panda
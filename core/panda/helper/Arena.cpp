@@ -0,0 +1,122 @@
+#include <panda/helper/Arena.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+namespace
+{
+
+using panda::helper::MonotonicArena;
+
+std::mutex& arenasMutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+std::vector<MonotonicArena*>& arenasList()
+{
+	static std::vector<MonotonicArena*> arenas;
+	return arenas;
+}
+
+struct ThreadArena // Registered so that the arenas of all threads can be reset at the end of a step
+{
+	ThreadArena()
+	{
+		std::lock_guard<std::mutex> lock(arenasMutex());
+		arenasList().push_back(&arena);
+	}
+
+	~ThreadArena()
+	{
+		std::lock_guard<std::mutex> lock(arenasMutex());
+		auto& arenas = arenasList();
+		arenas.erase(std::remove(arenas.begin(), arenas.end(), &arena), arenas.end());
+	}
+
+	MonotonicArena arena;
+};
+
+}
+
+namespace panda
+{
+
+namespace helper
+{
+
+MonotonicArena::MonotonicArena(std::size_t blockSize)
+	: m_blockSize(blockSize)
+{
+}
+
+void* MonotonicArena::allocate(std::size_t size, std::size_t alignment)
+{
+	while (true)
+	{
+		if (m_current < m_blocks.size())
+		{
+			auto& block = m_blocks[m_current];
+			const auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+			const auto aligned = (base + m_offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+			const std::size_t start = aligned - base;
+			if (start + size <= block.size)
+			{
+				m_offset = start + size;
+				return block.data.get() + start;
+			}
+
+			if (m_current + 1 < m_blocks.size()) // Try the next block, kept from a previous use
+			{
+				++m_current;
+				m_offset = 0;
+				continue;
+			}
+		}
+
+		// Each new block is bigger than the previous one, so that the number of blocks stays low
+		const std::size_t blockSize = std::max(m_blocks.empty() ? m_blockSize : m_blocks.back().size * 2, size + alignment);
+		m_blocks.push_back(Block{ std::unique_ptr<char[]>(new char[blockSize]), blockSize });
+		m_current = m_blocks.size() - 1;
+		m_offset = 0;
+	}
+}
+
+void MonotonicArena::reset()
+{
+	m_current = 0;
+	m_offset = 0;
+	if (m_blocks.size() <= 1)
+		return;
+
+	const std::size_t size = capacity();
+	m_blocks.clear();
+	m_blocks.push_back(Block{ std::unique_ptr<char[]>(new char[size]), size });
+}
+
+std::size_t MonotonicArena::capacity() const
+{
+	std::size_t size = 0;
+	for (const auto& block : m_blocks)
+		size += block.size;
+	return size;
+}
+
+MonotonicArena& threadArena()
+{
+	thread_local ThreadArena threadArena;
+	return threadArena.arena;
+}
+
+void resetThreadArenas()
+{
+	std::lock_guard<std::mutex> lock(arenasMutex());
+	for (auto arena : arenasList())
+		arena->reset();
+}
+
+} // namespace helper
+
+} // namespace panda
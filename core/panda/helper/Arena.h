@@ -0,0 +1,108 @@
+#ifndef HELPER_ARENA_H
+#define HELPER_ARENA_H
+
+#include <panda/core.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace panda
+{
+
+namespace helper
+{
+
+/// Monotonic allocator: memory is taken from big blocks and only released all at once (rewind or reset)
+class PANDA_CORE_API MonotonicArena
+{
+public:
+	explicit MonotonicArena(std::size_t blockSize = 64 * 1024);
+
+	void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+	struct Marker
+	{
+		std::size_t block = 0, offset = 0;
+	};
+	Marker mark() const; /// Current position
+	void rewind(const Marker& marker); /// Release everything allocated since the marker was taken (the blocks are kept)
+	void reset(); /// Release everything, and replace the blocks by a single one big enough for the peak usage
+
+	std::size_t capacity() const; /// Total size of the blocks
+	bool empty() const; /// Is nothing currently allocated
+
+private:
+	struct Block
+	{
+		std::unique_ptr<char[]> data;
+		std::size_t size;
+	};
+
+	std::size_t m_blockSize;
+	std::vector<Block> m_blocks;
+	std::size_t m_current = 0, m_offset = 0; // Position in the current block
+};
+
+/// Arena of the calling thread, for the temporaries of PandaObject::update
+/// A scope is opened around each update, so this memory must not be kept after update returns
+PANDA_CORE_API MonotonicArena& threadArena();
+PANDA_CORE_API void resetThreadArenas(); /// Reset the arenas of all threads, called at the end of each step (no object can be updating)
+
+/// Release the memory allocated in the arena during the lifetime of this object
+class ArenaScope
+{
+public:
+	explicit ArenaScope(MonotonicArena& arena = threadArena()) : m_arena(arena), m_marker(arena.mark()) {}
+	~ArenaScope() { m_arena.rewind(m_marker); }
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+	MonotonicArena& m_arena;
+	MonotonicArena::Marker m_marker;
+};
+
+/// STL allocator using an arena (the thread one by default), deallocate does nothing
+template <class T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+
+	ArenaAllocator() : m_arena(&threadArena()) {}
+	explicit ArenaAllocator(MonotonicArena& arena) : m_arena(&arena) {}
+	template <class U> ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena()) {}
+
+	T* allocate(std::size_t n) { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T*, std::size_t) {}
+
+	MonotonicArena* arena() const { return m_arena; }
+
+	template <class U> bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.arena(); }
+	template <class U> bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.arena(); }
+
+private:
+	MonotonicArena* m_arena;
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+//****************************************************************************//
+
+inline MonotonicArena::Marker MonotonicArena::mark() const
+{ Marker marker; marker.block = m_current; marker.offset = m_offset; return marker; }
+
+inline void MonotonicArena::rewind(const Marker& marker)
+{ m_current = marker.block; m_offset = marker.offset; }
+
+inline bool MonotonicArena::empty() const
+{ return !m_current && !m_offset; }
+
+} // namespace helper
+
+} // namespace panda
+
+#endif // HELPER_ARENA_H
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <panda/document/PandaDocument.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace panda
+{
+
+namespace helper
+{
+
+	/// Number of elements in each range, so that every thread gets a few ranges (for load balancing) but not too small ones
+	inline int parallelGrainSize(int count, int nbThreads, int minGrain)
+	{
+		const int rangesPerThread = 4;
+		const int nbRanges = std::max(nbThreads, 1) * rangesPerThread;
+		return std::max((count + nbRanges - 1) / nbRanges, std::max(minGrain, 1));
+	}
+
+	/// Call func(begin, end) on consecutive ranges covering [0, count), in parallel when the document uses multiple threads
+	/// minGrain is the minimum size of a range, so that cheap loops are not split more than necessary
+	template <class Func>
+	void parallelFor(const PandaDocument* document, int count, Func func, int minGrain = 256)
+	{
+		if (count <= 0)
+			return;
+
+		const int grain = parallelGrainSize(count, document->getNbParallelThreads(), minGrain);
+		const int nbChunks = (count + grain - 1) / grain;
+		if (nbChunks == 1)
+		{
+			func(0, count);
+			return;
+		}
+
+		document->parallelFor(nbChunks, [&](int chunk) {
+			const int begin = chunk * grain;
+			func(begin, std::min(begin + grain, count));
+		});
+	}
+
+	/// Compute func(begin, end) on ranges covering [0, count), then combine the partial results in order using op(T, T)
+	/// If deterministic, the ranges do not depend on the number of threads, so floating point results are always the same
+	template <class T, class Func, class Op>
+	T parallelReduce(const PandaDocument* document, int count, T init, Func func, Op op, bool deterministic = true, int minGrain = 256)
+	{
+		if (count <= 0)
+			return init;
+
+		const int fixedNbThreads = 16;
+		const int nbThreads = deterministic ? fixedNbThreads : document->getNbParallelThreads();
+		const int grain = parallelGrainSize(count, nbThreads, minGrain);
+		const int nbChunks = (count + grain - 1) / grain;
+		if (nbChunks == 1)
+			return op(init, func(0, count));
+
+		std::vector<T> partials(nbChunks);
+		document->parallelFor(nbChunks, [&](int chunk) {
+			const int begin = chunk * grain;
+			partials[chunk] = func(begin, std::min(begin + grain, count));
+		});
+
+		T result = init;
+		for (const auto& partial : partials)
+			result = op(result, partial);
+		return result;
+	}
+
+} // namespace helper
+
+} // namespace panda
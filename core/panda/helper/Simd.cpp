@@ -0,0 +1,278 @@
+#include <panda/helper/Simd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PANDA_SIMD_AVX2 1
+#define PANDA_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define PANDA_SIMD_AVX2 1
+#define PANDA_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#define PANDA_SIMD_AVX2 0
+#endif
+
+namespace
+{
+
+using panda::helper::simd::Statistics;
+
+const int lanes = 8; // Floats in an AVX register, the scalar kernels use as many accumulators
+
+bool detectAVX2()
+{
+#if PANDA_SIMD_AVX2 && defined(__GNUC__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#elif PANDA_SIMD_AVX2
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) // The OS must save the AVX registers
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return false;
+#endif
+}
+
+const bool cpuHasAVX2 = detectAVX2();
+std::atomic_bool useAVX2(cpuHasAVX2);
+
+float sumLanes(const float* acc)
+{
+	float total = 0;
+	for (int j = 0; j < lanes; ++j)
+		total += acc[j];
+	return total;
+}
+
+void sumInterleavedLanes(const float* acc, float& sumX, float& sumY) // The even lanes contain x values, the odd ones y values
+{
+	sumX = sumY = 0;
+	for (int j = 0; j < lanes; j += 2)
+	{
+		sumX += acc[j];
+		sumY += acc[j + 1];
+	}
+}
+
+// The AVX2 version of distanceMoments computes the squared distances of 8 points with _mm256_hadd_ps, which puts them in this order
+const int pointLanes[lanes] = { 0, 1, 4, 5, 2, 3, 6, 7 };
+
+// Scalar kernels
+
+Statistics statisticsScalar(const float* values, int count)
+{
+	float acc[lanes] = {}, acc2[lanes] = {};
+	float vMin = values[0], vMax = values[0];
+	for (int i = 0; i < count; ++i)
+	{
+		const float v = values[i];
+		const int j = i % lanes;
+		acc[j] += v;
+		acc2[j] += v * v;
+		vMin = std::min(vMin, v);
+		vMax = std::max(vMax, v);
+	}
+
+	Statistics stats;
+	stats.sum = sumLanes(acc);
+	stats.sum2 = sumLanes(acc2);
+	stats.min = vMin;
+	stats.max = vMax;
+	return stats;
+}
+
+void sumPointsScalar(const float* xy, int count, float& sumX, float& sumY)
+{
+	float acc[lanes] = {};
+	for (int i = 0; i < 2 * count; ++i)
+		acc[i % lanes] += xy[i];
+	sumInterleavedLanes(acc, sumX, sumY);
+}
+
+void distanceMomentsScalar(const float* xy, int count, float cx, float cy, float& sumDist, float& sumDist2)
+{
+	float acc[lanes] = {}, acc2[lanes] = {};
+	for (int i = 0; i < count; ++i)
+	{
+		const float dx = xy[2 * i] - cx, dy = xy[2 * i + 1] - cy;
+		const float d2 = dx * dx + dy * dy;
+		const int j = pointLanes[i % lanes];
+		acc[j] += std::sqrt(d2);
+		acc2[j] += d2;
+	}
+	sumDist = sumLanes(acc);
+	sumDist2 = sumLanes(acc2);
+}
+
+// AVX2 kernels, the remaining values (less than a register) are added to the lanes like in the scalar versions
+
+#if PANDA_SIMD_AVX2
+
+PANDA_TARGET_AVX2 Statistics statisticsAVX2(const float* values, int count)
+{
+	const int end = count - count % lanes;
+	__m256 acc = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps();
+	__m256 vMin = _mm256_set1_ps(values[0]), vMax = vMin;
+	for (int i = 0; i < end; i += lanes)
+	{
+		const __m256 v = _mm256_loadu_ps(values + i);
+		acc = _mm256_add_ps(acc, v);
+		acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(v, v));
+		vMin = _mm256_min_ps(vMin, v);
+		vMax = _mm256_max_ps(vMax, v);
+	}
+
+	float sums[lanes], sums2[lanes], mins[lanes], maxs[lanes];
+	_mm256_storeu_ps(sums, acc);
+	_mm256_storeu_ps(sums2, acc2);
+	_mm256_storeu_ps(mins, vMin);
+	_mm256_storeu_ps(maxs, vMax);
+
+	float tMin = values[0], tMax = values[0];
+	for (int j = 0; j < lanes; ++j)
+	{
+		tMin = std::min(tMin, mins[j]);
+		tMax = std::max(tMax, maxs[j]);
+	}
+
+	for (int i = end; i < count; ++i)
+	{
+		const float v = values[i];
+		const int j = i % lanes;
+		sums[j] += v;
+		sums2[j] += v * v;
+		tMin = std::min(tMin, v);
+		tMax = std::max(tMax, v);
+	}
+
+	Statistics stats;
+	stats.sum = sumLanes(sums);
+	stats.sum2 = sumLanes(sums2);
+	stats.min = tMin;
+	stats.max = tMax;
+	return stats;
+}
+
+PANDA_TARGET_AVX2 void sumPointsAVX2(const float* xy, int count, float& sumX, float& sumY)
+{
+	const int nbValues = 2 * count, end = nbValues - nbValues % lanes;
+	__m256 acc = _mm256_setzero_ps();
+	for (int i = 0; i < end; i += lanes)
+		acc = _mm256_add_ps(acc, _mm256_loadu_ps(xy + i));
+
+	float sums[lanes];
+	_mm256_storeu_ps(sums, acc);
+	for (int i = end; i < nbValues; ++i)
+		sums[i % lanes] += xy[i];
+	sumInterleavedLanes(sums, sumX, sumY);
+}
+
+PANDA_TARGET_AVX2 void distanceMomentsAVX2(const float* xy, int count, float cx, float cy, float& sumDist, float& sumDist2)
+{
+	const int end = count - count % lanes; // 8 points (2 registers) per iteration
+	const __m256 center = _mm256_setr_ps(cx, cy, cx, cy, cx, cy, cx, cy);
+	__m256 acc = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps();
+	for (int i = 0; i < end; i += lanes)
+	{
+		const __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(xy + 2 * i), center);
+		const __m256 d2 = _mm256_sub_ps(_mm256_loadu_ps(xy + 2 * i + lanes), center);
+		const __m256 dist2 = _mm256_hadd_ps(_mm256_mul_ps(d1, d1), _mm256_mul_ps(d2, d2)); // dx * dx + dy * dy, see pointLanes for the order
+		acc = _mm256_add_ps(acc, _mm256_sqrt_ps(dist2));
+		acc2 = _mm256_add_ps(acc2, dist2);
+	}
+
+	float sums[lanes], sums2[lanes];
+	_mm256_storeu_ps(sums, acc);
+	_mm256_storeu_ps(sums2, acc2);
+	for (int i = end; i < count; ++i)
+	{
+		const float dx = xy[2 * i] - cx, dy = xy[2 * i + 1] - cy;
+		const float d2 = dx * dx + dy * dy;
+		const int j = pointLanes[i % lanes];
+		sums[j] += std::sqrt(d2);
+		sums2[j] += d2;
+	}
+	sumDist = sumLanes(sums);
+	sumDist2 = sumLanes(sums2);
+}
+
+bool avx2()
+{
+	return useAVX2.load(std::memory_order_relaxed);
+}
+
+#endif // PANDA_SIMD_AVX2
+
+} // namespace
+
+namespace panda
+{
+
+namespace helper
+{
+
+namespace simd
+{
+
+bool hasAVX2()
+{
+	return cpuHasAVX2;
+}
+
+void setAVX2Enabled(bool enabled)
+{
+	useAVX2 = enabled && cpuHasAVX2;
+}
+
+Statistics statistics(const float* values, int count)
+{
+	if (count <= 0)
+		return Statistics();
+#if PANDA_SIMD_AVX2
+	if (avx2())
+		return statisticsAVX2(values, count);
+#endif
+	return statisticsScalar(values, count);
+}
+
+void sumPoints(const float* xy, int count, float& sumX, float& sumY)
+{
+#if PANDA_SIMD_AVX2
+	if (avx2())
+	{
+		sumPointsAVX2(xy, count, sumX, sumY);
+		return;
+	}
+#endif
+	sumPointsScalar(xy, count, sumX, sumY);
+}
+
+void distanceMoments(const float* xy, int count, float cx, float cy, float& sumDist, float& sumDist2)
+{
+#if PANDA_SIMD_AVX2
+	if (avx2())
+	{
+		distanceMomentsAVX2(xy, count, cx, cy, sumDist, sumDist2);
+		return;
+	}
+#endif
+	distanceMomentsScalar(xy, count, cx, cy, sumDist, sumDist2);
+}
+
+} // namespace simd
+
+} // namespace helper
+
+} // namespace panda
@@ -0,0 +1,40 @@
+#ifndef HELPER_SIMD_H
+#define HELPER_SIMD_H
+
+#include <panda/core.h>
+
+namespace panda
+{
+
+namespace helper
+{
+
+/// Kernels working on arrays of floats
+/// They use AVX2 if the CPU supports it, the choice is done once at runtime
+/// The scalar versions accumulate in the same order, so the results do not depend on the CPU
+namespace simd
+{
+
+	PANDA_CORE_API bool hasAVX2(); /// Can this CPU run the AVX2 kernels
+	PANDA_CORE_API void setAVX2Enabled(bool enabled); /// Force the use of the scalar kernels if false (for comparison)
+
+	struct Statistics
+	{
+		float sum = 0, sum2 = 0; // Sum of the values and of their squares
+		float min = 0, max = 0;
+	};
+	PANDA_CORE_API Statistics statistics(const float* values, int count);
+
+	/// The following kernels work on interleaved points (x0, y0, x1, y1, ...), the layout of std::vector<Point>, count is the number of points
+	PANDA_CORE_API void sumPoints(const float* xy, int count, float& sumX, float& sumY);
+
+	/// Sums of the distances and of the squared distances between the points and (cx, cy)
+	PANDA_CORE_API void distanceMoments(const float* xy, int count, float cx, float cy, float& sumDist, float& sumDist2);
+
+} // namespace simd
+
+} // namespace helper
+
+} // namespace panda
+
+#endif // HELPER_SIMD_H
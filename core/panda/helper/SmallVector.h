@@ -0,0 +1,176 @@
+#ifndef HELPER_SMALLVECTOR_H
+#define HELPER_SMALLVECTOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+namespace panda
+{
+
+namespace helper
+{
+
+/// Vector storing up to N values inside the object, and only allocating when it grows bigger
+/// Limited to trivial types (like pointers), as the values are copied with memcpy
+template <class T, unsigned int N>
+class SmallVector
+{
+	static_assert(std::is_trivial<T>::value, "SmallVector can only store trivial types");
+	static_assert(N > 0, "Use std::vector if there is no inline storage");
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	SmallVector() {}
+	SmallVector(std::initializer_list<T> list) { assign(list.begin(), list.end()); }
+	SmallVector(const T* first, const T* last) { assign(first, last); }
+	SmallVector(const SmallVector& other) { assign(other.begin(), other.end()); }
+	SmallVector(SmallVector&& other) { moveFrom(other); }
+	~SmallVector() { release(); }
+
+	SmallVector& operator=(const SmallVector& other);
+	SmallVector& operator=(SmallVector&& other);
+
+	iterator begin() { return data(); }
+	iterator end() { return data() + m_size; }
+	const_iterator begin() const { return data(); }
+	const_iterator end() const { return data() + m_size; }
+
+	T* data() { return isInline() ? m_inline : m_heap; }
+	const T* data() const { return isInline() ? m_inline : m_heap; }
+
+	size_type size() const { return m_size; }
+	size_type capacity() const { return m_capacity; }
+	bool empty() const { return !m_size; }
+	bool isInline() const { return m_capacity == N; } /// Are the values stored inside the object
+
+	T& operator[](size_type index) { return data()[index]; }
+	const T& operator[](size_type index) const { return data()[index]; }
+	T& front() { return data()[0]; }
+	const T& front() const { return data()[0]; }
+	T& back() { return data()[m_size - 1]; }
+	const T& back() const { return data()[m_size - 1]; }
+
+	void push_back(const T& value);
+	void pop_back() { --m_size; }
+	void clear() { m_size = 0; }
+	void reserve(size_type capacity);
+	void assign(const T* first, const T* last);
+
+	iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+	iterator erase(const_iterator first, const_iterator last);
+
+private:
+	void release();
+	void moveFrom(SmallVector& other);
+
+	uint32_t m_size = 0, m_capacity = N; // The capacity is only N when using the inline storage
+	union
+	{
+		T m_inline[N];
+		T* m_heap;
+	};
+};
+
+//****************************************************************************//
+
+template <class T, unsigned int N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& other)
+{
+	if (this != &other)
+		assign(other.begin(), other.end());
+	return *this;
+}
+
+template <class T, unsigned int N>
+SmallVector<T, N>& SmallVector<T, N>::operator=(SmallVector&& other)
+{
+	if (this != &other)
+	{
+		release();
+		moveFrom(other);
+	}
+	return *this;
+}
+
+template <class T, unsigned int N>
+void SmallVector<T, N>::push_back(const T& value)
+{
+	if (m_size == m_capacity)
+	{
+		const T copy = value; // The value can be in this vector
+		reserve(m_capacity * 2);
+		data()[m_size++] = copy;
+	}
+	else
+		data()[m_size++] = value;
+}
+
+template <class T, unsigned int N>
+void SmallVector<T, N>::reserve(size_type capacity)
+{
+	if (capacity <= m_capacity)
+		return;
+
+	T* values = static_cast<T*>(::operator new(capacity * sizeof(T)));
+	std::memcpy(values, data(), m_size * sizeof(T));
+	release();
+	m_heap = values;
+	m_capacity = static_cast<uint32_t>(capacity);
+}
+
+template <class T, unsigned int N>
+void SmallVector<T, N>::assign(const T* first, const T* last)
+{
+	const auto size = static_cast<size_type>(last - first);
+	m_size = 0;
+	reserve(size);
+	std::memmove(data(), first, size * sizeof(T));
+	m_size = static_cast<uint32_t>(size);
+}
+
+template <class T, unsigned int N>
+typename SmallVector<T, N>::iterator SmallVector<T, N>::erase(const_iterator first, const_iterator last)
+{
+	T* pos = data() + (first - data());
+	std::memmove(pos, last, (end() - last) * sizeof(T));
+	m_size -= static_cast<uint32_t>(last - first);
+	return pos;
+}
+
+template <class T, unsigned int N>
+void SmallVector<T, N>::release()
+{
+	if (!isInline())
+		::operator delete(m_heap);
+	m_capacity = N;
+}
+
+template <class T, unsigned int N>
+void SmallVector<T, N>::moveFrom(SmallVector& other)
+{
+	m_size = other.m_size;
+	m_capacity = other.m_capacity;
+	if (other.isInline())
+		std::memcpy(m_inline, other.m_inline, m_size * sizeof(T));
+	else
+		m_heap = other.m_heap;
+
+	other.m_size = 0;
+	other.m_capacity = N;
+}
+
+} // namespace helper
+
+} // namespace panda
+
+#endif // HELPER_SMALLVECTOR_H
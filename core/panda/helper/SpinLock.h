@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+namespace panda
+{
+
+namespace helper
+{
+
+	/// Lightweight lock for very short critical sections, usable with std::lock_guard
+	class SpinLock
+	{
+	public:
+		void lock()
+		{
+			while (m_flag.test_and_set(std::memory_order_acquire))
+				std::this_thread::yield();
+		}
+
+		bool try_lock()
+		{ return !m_flag.test_and_set(std::memory_order_acquire); }
+
+		void unlock()
+		{ m_flag.clear(std::memory_order_release); }
+
+	private:
+		std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
+	};
+
+} // namespace helper
+
+} // namespace panda
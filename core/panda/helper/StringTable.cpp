@@ -0,0 +1,98 @@
+#include <panda/helper/StringTable.h>
+#include <panda/helper/Exception.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+
+using panda::helper::StringId;
+
+const int chunkBits = 10; // The strings are stored in chunks so that they never move
+const StringId chunkSize = 1 << chunkBits;
+const int maxChunks = 4096;
+
+// The map uses the strings stored in the chunks as keys, so that they are not stored twice
+struct StringPtrHash
+{
+	std::size_t operator()(const std::string* str) const { return std::hash<std::string>()(*str); }
+};
+
+struct StringPtrEqual
+{
+	bool operator()(const std::string* lhs, const std::string* rhs) const { return *lhs == *rhs; }
+};
+
+class StringTable
+{
+public:
+	StringTable()
+	{
+		m_chunks[0].reset(new std::string[chunkSize]);
+		m_ids[&m_chunks[0][0]] = 0;
+		m_count = 1;
+	}
+
+	StringId intern(const std::string& str)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_ids.find(&str);
+		if (it != m_ids.end())
+			return it->second;
+
+		const StringId id = m_count;
+		if ((id >> chunkBits) >= maxChunks) // The chunks cannot be in a growing vector, get is not locked
+			throw panda::helper::Exception("The string table is full");
+
+		++m_count;
+		auto& chunk = m_chunks[id >> chunkBits];
+		if (!chunk)
+			chunk.reset(new std::string[chunkSize]);
+		auto& stored = chunk[id & (chunkSize - 1)];
+		stored = str;
+		m_ids.emplace(&stored, id);
+		return id;
+	}
+
+	// Not locked: an id is only known after its string and its chunk were written, and they are never modified again
+	const std::string& get(StringId id) const
+	{ return m_chunks[id >> chunkBits][id & (chunkSize - 1)]; }
+
+private:
+	std::mutex m_mutex;
+	std::unordered_map<const std::string*, StringId, StringPtrHash, StringPtrEqual> m_ids;
+	std::unique_ptr<std::string[]> m_chunks[maxChunks];
+	StringId m_count = 0;
+};
+
+StringTable& stringTable()
+{
+	static StringTable table;
+	return table;
+}
+
+}
+
+namespace panda
+{
+
+namespace helper
+{
+
+StringId internString(const std::string& str)
+{
+	if (str.empty())
+		return 0;
+	return stringTable().intern(str);
+}
+
+const std::string& internedString(StringId id)
+{
+	return stringTable().get(id);
+}
+
+} // namespace helper
+
+} // namespace panda
@@ -0,0 +1,26 @@
+#ifndef HELPER_STRINGTABLE_H
+#define HELPER_STRINGTABLE_H
+
+#include <panda/core.h>
+
+#include <cstdint>
+#include <string>
+
+namespace panda
+{
+
+namespace helper
+{
+
+using StringId = uint32_t;
+
+/// Strings shared by the whole process: each one is stored once and referenced by its id
+/// They are never removed, use it for the names and descriptions repeated in many objects
+PANDA_CORE_API StringId internString(const std::string& str); /// Id of this string, added to the table if needed (the empty string is always 0)
+PANDA_CORE_API const std::string& internedString(StringId id); /// The reference stays valid for the lifetime of the process
+
+} // namespace helper
+
+} // namespace panda
+
+#endif // HELPER_STRINGTABLE_H
@@ -0,0 +1,150 @@
+#include <panda/helper/TraceExport.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+
+namespace
+{
+
+using panda::helper::EventData;
+using panda::helper::EventType;
+
+const char* eventCategory(EventType type)
+{
+	switch (type)
+	{
+	case panda::helper::event_update:		return "update";
+	case panda::helper::event_getValue:		return "getValue";
+	case panda::helper::event_render:		return "render";
+	case panda::helper::event_copyValue:	return "copyValue";
+	case panda::helper::event_setDirty:		return "setDirty";
+	default:								return "custom";
+	}
+}
+
+void writeString(std::ostream& out, const std::string& text)
+{
+	out << '"';
+	for (char c : text)
+	{
+		switch (c)
+		{
+		case '"':	out << "\\\""; break;
+		case '\\':	out << "\\\\"; break;
+		case '\n':	out << "\\n"; break;
+		case '\t':	out << "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char buffer[8];
+				std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+				out << buffer;
+			}
+			else
+				out << c;
+		}
+	}
+	out << '"';
+}
+
+// The timestamps of the trace format are in microseconds, the events are in nanoseconds
+void writeTime(std::ostream& out, long long nanoseconds)
+{
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", nanoseconds / 1000, nanoseconds % 1000);
+	out << buffer;
+}
+
+void writeThreadName(std::ostream& out, int tid, const std::string& name, int sortIndex)
+{
+	out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+	writeString(out, name);
+	out << "}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"sort_index\":" << sortIndex << "}}";
+}
+
+}
+
+namespace panda
+{
+
+namespace helper
+{
+
+void writeChromeTrace(std::ostream& out, const UpdateLogger::Frames& frames)
+{
+	// All times are relative to the first event
+	long long origin = LLONG_MAX;
+	std::size_t nbThreads = 0;
+	for (const auto& frame : frames)
+	{
+		nbThreads = std::max(nbThreads, frame.size());
+		for (const auto& events : frame)
+		{
+			for (const auto& event : events)
+				origin = std::min(origin, event.m_startTime);
+		}
+	}
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+	// The steps are on the track 0, the thread i on the track i + 1
+	writeThreadName(out, 0, "Steps", 0);
+	for (std::size_t i = 0; i < nbThreads; ++i)
+	{
+		out << ",\n";
+		writeThreadName(out, static_cast<int>(i + 1), i ? "Thread " + std::to_string(i) : std::string("Main thread"), static_cast<int>(i + 1));
+	}
+
+	for (std::size_t frameIndex = 0; frameIndex < frames.size(); ++frameIndex)
+	{
+		const auto& frame = frames[frameIndex];
+		long long frameStart = LLONG_MAX, frameEnd = LLONG_MIN;
+		for (std::size_t threadId = 0; threadId < frame.size(); ++threadId)
+		{
+			for (const auto& event : frame[threadId])
+			{
+				frameStart = std::min(frameStart, event.m_startTime);
+				frameEnd = std::max(frameEnd, event.m_endTime);
+
+				out << ",\n{\"name\":";
+				writeString(out, event.text());
+				out << ",\"cat\":\"" << eventCategory(event.m_type) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId + 1 << ",\"ts\":";
+				writeTime(out, event.m_startTime - origin);
+				out << ",\"dur\":";
+				writeTime(out, event.m_endTime - event.m_startTime);
+				out << ",\"args\":{\"frame\":" << frameIndex
+					<< ",\"object\":" << event.m_objectIndex
+					<< ",\"dirtyStart\":" << (event.m_dirtyStart ? "true" : "false")
+					<< ",\"dirtyEnd\":" << (event.m_dirtyEnd ? "true" : "false") << "}}";
+			}
+		}
+
+		if (frameStart > frameEnd) // No event in this frame
+			continue;
+
+		out << ",\n{\"name\":\"Step " << frameIndex << "\",\"cat\":\"step\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":";
+		writeTime(out, frameStart - origin);
+		out << ",\"dur\":";
+		writeTime(out, frameEnd - frameStart);
+		out << "}";
+	}
+
+	out << "\n]}\n";
+}
+
+bool writeChromeTrace(const std::string& path, const UpdateLogger::Frames& frames)
+{
+	std::ofstream out(path);
+	if (!out)
+		return false;
+
+	writeChromeTrace(out, frames);
+	return static_cast<bool>(out);
+}
+
+} // namespace helper
+
+} // namespace panda
@@ -0,0 +1,24 @@
+#ifndef HELPER_TRACEEXPORT_H
+#define HELPER_TRACEEXPORT_H
+
+#include <panda/helper/UpdateLogger.h>
+
+#include <iosfwd>
+#include <string>
+
+namespace panda
+{
+
+namespace helper
+{
+
+/// Write the frames captured by the UpdateLogger in the Chrome trace event format (JSON)
+/// The file can be opened in chrome://tracing or in the Perfetto UI, with one track per thread and one for the steps
+PANDA_CORE_API void writeChromeTrace(std::ostream& out, const UpdateLogger::Frames& frames);
+PANDA_CORE_API bool writeChromeTrace(const std::string& path, const UpdateLogger::Frames& frames); /// Return false if the file could not be written
+
+} // namespace helper
+
+} // namespace panda
+
+#endif // HELPER_TRACEEXPORT_H
@@ -4,7 +4,7 @@
 #include <panda/object/PandaObject.h>
 
 #include <chrono>
-#include <thread>
+#include <unordered_map>
 
 namespace
 {
@@ -13,6 +13,20 @@ namespace
 inline long long getTime()
 { return std::chrono::high_resolution_clock::now().time_since_epoch().count(); }
 
+thread_local int threadIndex = 0; // Set by UpdateLogger::setupThread
+
+// The texts of the custom events are literals, each thread remembers their ids to not lock the string table every time
+panda::helper::StringId literalId(const char* text)
+{
+	thread_local std::unordered_map<const char*, panda::helper::StringId> ids;
+	auto it = ids.find(text);
+	if (it != ids.end())
+		return it->second;
+	auto id = panda::helper::internString(text);
+	ids.emplace(text, id);
+	return id;
+}
+
 }
 
 
@@ -24,13 +38,14 @@ namespace helper
 
 #ifdef PANDA_LOG_EVENTS
 
-ScopedEvent::ScopedEvent(EventType type, const PandaObject *object)
-	: m_changeLevel(true)
+void ScopedEvent::start(EventType type, const PandaObject *object)
 {
+	m_changeLevel = true;
 	m_event.m_type = type;
 	m_event.m_node = object;
 	m_event.m_objectIndex = object->getIndex();
-	m_event.m_text = object->getName();
+	m_event.m_text = object->getNameId();
+	m_event.m_dataName = 0;
 	m_event.m_threadId = UpdateLogger::getThreadId();
 	m_event.m_level = ++UpdateLogger::getInstance()->logLevel(m_event.m_threadId);
 
@@ -38,21 +53,22 @@ ScopedEvent::ScopedEvent(EventType type, const PandaObject *object)
 	m_event.m_dirtyStart = object->isDirty();
 }
 
-ScopedEvent::ScopedEvent(EventType type, const BaseData* data)
-	: m_changeLevel(false)
+void ScopedEvent::start(EventType type, const BaseData* data)
 {
+	m_changeLevel = false;
 	m_event.m_type = type;
 	m_event.m_node = data;
+	m_event.m_dataName = data->getNameId();
 	PandaObject* owner = data->getOwner();
 	if(owner)
 	{
 		m_event.m_objectIndex = owner->getIndex();
-		m_event.m_text = owner->getName() + "/" + data->getName();
+		m_event.m_text = owner->getNameId();
 	}
 	else
 	{
 		m_event.m_objectIndex = -1;
-		m_event.m_text = data->getName();
+		m_event.m_text = 0;
 	}
 	m_event.m_threadId = UpdateLogger::getThreadId();
 	m_event.m_level = UpdateLogger::getInstance()->logLevel(m_event.m_threadId);
@@ -63,12 +79,24 @@ ScopedEvent::ScopedEvent(EventType type, const BaseData* data)
 	m_event.m_dirtyStart = data->isDirty();
 }
 
-ScopedEvent::ScopedEvent(const std::string& text, DataNode* node)
-	: m_changeLevel(true)
+void ScopedEvent::start(const char* text, DataNode* node)
 {
+	start(literalId(text), node);
+}
+
+void ScopedEvent::start(const std::string& text, DataNode* node)
+{
+	start(internString(text), node);
+}
+
+void ScopedEvent::start(StringId text, DataNode* node)
+{
+	m_changeLevel = true;
 	m_event.m_type = event_custom;
 	m_event.m_node = node;
 	m_event.m_text = text;
+	m_event.m_dataName = 0;
+	m_event.m_objectIndex = -1;
 	m_event.m_threadId = UpdateLogger::getThreadId();
 	m_event.m_level = ++UpdateLogger::getInstance()->logLevel(m_event.m_threadId);
 
@@ -88,14 +116,12 @@ ScopedEvent::ScopedEvent(const std::string& text, DataNode* node)
 			}
 		}
 	}
-	else
-		m_event.m_objectIndex = -1;
 
 	m_event.m_startTime = getTime();
 	m_event.m_dirtyStart = true;
 }
 
-ScopedEvent::~ScopedEvent()
+void ScopedEvent::stop()
 {
 	auto logger = UpdateLogger::getInstance();
 	m_event.m_endTime = getTime();
@@ -107,20 +133,36 @@ ScopedEvent::~ScopedEvent()
 	if(m_changeLevel)
 		--logger->logLevel(m_event.m_threadId);
 
-	logger->addEvent(std::move(m_event));
+	logger->addEvent(m_event);
 }
 
 #endif // PANDA_LOG_EVENTS
 
 //****************************************************************************//
 
+std::string EventData::text() const
+{
+	if(!m_dataName)
+		return internedString(m_text);
+	if(!m_text)
+		return internedString(m_dataName);
+	return internedString(m_text) + "/" + internedString(m_dataName);
+}
+
+//****************************************************************************//
+
+std::atomic<unsigned int> UpdateLogger::s_recordedEvents(0);
+
 UpdateLogger::UpdateLogger()
 	: m_nbThreads(1)
+	, m_eventsCapacity(1 << 14)
+	, m_enabled(false)
+	, m_eventsMask(allEvents)
 	, m_logging(false)
 	, m_document(nullptr)
+	, m_nbFramesToCapture(0)
 {
-	m_logLevelMap.push_back(-1);
-	m_events.resize(m_nbThreads);
+	createRings();
 	m_prevEvents.resize(m_nbThreads);
 }
 
@@ -130,19 +172,31 @@ UpdateLogger* UpdateLogger::getInstance()
 	return &instance;
 }
 
+void UpdateLogger::setEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+void UpdateLogger::setEventsMask(unsigned int mask)
+{
+	m_eventsMask = mask & allEvents;
+	if(m_logging)
+		s_recordedEvents = m_eventsMask;
+}
+
 void UpdateLogger::startLog(PandaDocument* doc)
 {
 	m_document = doc;
 	if(m_logging)
 		stopLog();
+	if(!m_enabled && !isCapturing())
+		return; // Keep the events of the last log
 
-	m_events.resize(m_nbThreads);
-	for (auto& events : m_events)
-		events.clear();
-	
-	m_logging = true;
-
-	m_logLevelMap.resize(m_nbThreads, -1);
+	for (auto& ring : m_rings)
+	{
+		ring->written = 0;
+		ring->level = -1;
+	}
 
 	m_nodeStates.clear();
 	for (auto& object : doc->getObjectsList().get())
@@ -152,17 +206,64 @@ void UpdateLogger::startLog(PandaDocument* doc)
 		for(BaseData* data : object->getDatas())
 			m_nodeStates[data] = data->isDirty();
 	}
+
+	m_logging = true;
+	s_recordedEvents = m_eventsMask;
 }
 
 void UpdateLogger::stopLog()
 {
+	if(!m_logging)
+		return;
+
+	s_recordedEvents = 0;
 	m_logging = false;
-	m_prevEvents.swap(m_events);
+
+	// Copy the events of each ring, in the order they were added
+	m_prevEvents.resize(m_nbThreads);
+	for (int i = 0; i < m_nbThreads; ++i)
+	{
+		const auto& ring = *m_rings[i];
+		const unsigned long long written = ring.written.load(std::memory_order_acquire);
+		const unsigned long long capacity = ring.events.size();
+		const unsigned long long first = written > capacity ? written - capacity : 0;
+
+		auto& events = m_prevEvents[i];
+		events.clear();
+		events.reserve(static_cast<std::size_t>(written - first));
+		for (unsigned long long j = first; j < written; ++j)
+			events.push_back(ring.events[j % capacity]);
+	}
+
 	m_prevNodeStates.swap(m_nodeStates);
+
+	if(isCapturing())
+	{
+		m_capturedFrames.push_back(m_prevEvents);
+		if(!--m_nbFramesToCapture)
+		{
+			auto frames = std::move(m_capturedFrames);
+			auto callback = std::move(m_captureCallback);
+			m_capturedFrames.clear();
+			m_captureCallback = nullptr;
+			if(callback)
+				callback(frames);
+		}
+	}
+}
+
+void UpdateLogger::captureFrames(int nbFrames, CaptureCallback callback)
+{
+	m_capturedFrames.clear();
+	m_nbFramesToCapture = nbFrames > 0 ? nbFrames : 0;
+	m_captureCallback = m_nbFramesToCapture ? std::move(callback) : nullptr;
 }
 
 void UpdateLogger::updateDirtyStates()
 {
+	if(!m_logging)
+		return;
+
 	for (auto& object : m_document->getObjectsList().get())
 	{
 		m_nodeStates[object.get()] = object->isDirty();
@@ -174,6 +275,8 @@ void UpdateLogger::updateDirtyStates()
 
 const UpdateLogger::UpdateEvents UpdateLogger::getEvents(int id) const
 {
+	if(id < 0 || id >= static_cast<int>(m_prevEvents.size()))
+		return UpdateEvents();
 	return m_prevEvents[id];
 }
 
@@ -186,33 +289,52 @@ void UpdateLogger::setNbThreads(int nbThreads)
 {
 	if(m_nbThreads != nbThreads)
 	{
-		m_events.clear();
-		m_events.resize(nbThreads);
 		m_nbThreads = nbThreads;
+		createRings();
+	}
+}
+
+void UpdateLogger::setEventsCapacity(int capacity)
+{
+	if(m_eventsCapacity != capacity && capacity > 0)
+	{
+		m_eventsCapacity = capacity;
+		m_rings.clear();
+		createRings();
 	}
 }
 
-typedef std::map<std::thread::id, int> ThreadIdMap;
-inline ThreadIdMap& getThreadIdMap()
+void UpdateLogger::createRings()
 {
-	static ThreadIdMap theMap;
-	return theMap;
+	// Must not be called during a log, the threads write in the rings without locking
+	m_rings.resize(m_nbThreads);
+	for (auto& ring : m_rings)
+	{
+		if (!ring)
+			ring = std::make_unique<EventsRing>(m_eventsCapacity);
+	}
 }
 
 void UpdateLogger::setupThread(int id)
 {
-	getThreadIdMap()[std::this_thread::get_id()] = id;
+	threadIndex = id;
 }
 
 int UpdateLogger::getThreadId()
 {
-	return getThreadIdMap()[std::this_thread::get_id()];
+	return threadIndex;
 }
 
-void UpdateLogger::addEvent(EventData event)
+void UpdateLogger::addEvent(const EventData& event)
 {
-	if(m_logging)
-		m_events[getThreadId()].push_back(std::move(event));
+	if(!m_logging.load(std::memory_order_relaxed))
+		return;
+
+	// Only the thread with this index writes in this ring
+	auto& ring = *m_rings[event.m_threadId];
+	const auto index = ring.written.load(std::memory_order_relaxed);
+	ring.events[index % ring.events.size()] = event;
+	ring.written.store(index + 1, std::memory_order_release);
 }
 
 } // namespace helper
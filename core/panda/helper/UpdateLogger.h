@@ -2,8 +2,12 @@
 #define UPDATELOGGER_H
 
 #include <panda/core.h>
+#include <panda/helper/StringTable.h>
 
+#include <atomic>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -29,13 +33,19 @@ enum EventType
 	event_custom	// For any other event we want to time, that does not have to be connected to a DataNode
 };
 
-// This is what will actually be stored
+// Masks of the types of events to record (see UpdateLogger::setEventsMask)
+inline unsigned int eventBit(EventType type) { return 1u << type; }
+const unsigned int allEvents = (1u << (event_custom + 1)) - 1;
+
+// This is what will actually be stored (no allocation, the strings are in the string table)
 struct EventData
 {
 public:
+	std::string text() const; // Text shown for this event
+
 	EventType m_type;
 	long long m_startTime, m_endTime;
-	std::string m_text;
+	StringId m_text, m_dataName; // Name of the object (or custom text), and name of the Data for the events of a Data
 	int m_objectIndex, m_level, m_threadId;
 	bool m_dirtyStart, m_dirtyEnd;
 	const DataNode* m_node;
@@ -44,16 +54,26 @@ public:
 #ifdef PANDA_LOG_EVENTS
 
 // To log an event, you only have to use this class
+// Nothing else than a test of UpdateLogger::isRecording is done if the logger does not record this type of event
 class PANDA_CORE_API ScopedEvent
 {
 public:
 	ScopedEvent(EventType type, const PandaObject* object);
 	ScopedEvent(EventType type, const BaseData* data);
+	ScopedEvent(const char* text, DataNode* node = nullptr); // The text must be a literal (its pointer is used to cache its id)
 	ScopedEvent(const std::string& text, DataNode* node = nullptr);
 	~ScopedEvent();
 
 private:
+	void start(EventType type, const PandaObject* object);
+	void start(EventType type, const BaseData* data);
+	void start(const char* text, DataNode* node);
+	void start(const std::string& text, DataNode* node);
+	void start(StringId text, DataNode* node);
+	void stop();
+
 	EventData m_event;
+	bool m_active; // Is this event recorded
 	bool m_changeLevel; // Do we have to change the level back in the destructor
 };
 
@@ -65,6 +85,7 @@ class PANDA_CORE_API ScopedEvent
 public:
 	ScopedEvent(EventType type, const PandaObject* object) {}
 	ScopedEvent(EventType type, const BaseData* data) {}
+	ScopedEvent(const char* text, DataNode* node = nullptr) {}
 	ScopedEvent(const std::string& text, DataNode* node = nullptr) {}
 };
 
@@ -75,10 +96,19 @@ class PANDA_CORE_API UpdateLogger
 {
 public:
 	typedef std::vector<EventData> UpdateEvents;
+	typedef std::vector<UpdateEvents> FrameEvents; // The events of each thread during one log
+	typedef std::vector<FrameEvents> Frames;
 	typedef std::map<const DataNode*, bool> NodeStates;
+	using CaptureCallback = std::function<void(const Frames&)>;
 
 	static UpdateLogger* getInstance();
 	static int getThreadId();
+	static bool isRecording(EventType type); /// Is a log running and recording this type of event
+
+	void setEnabled(bool enabled); /// If false (the default), startLog does nothing and the events are not even timed
+	bool isEnabled() const;
+	void setEventsMask(unsigned int mask); /// Types of events to record, combination of eventBit (allEvents by default)
+	unsigned int getEventsMask() const;
 
 	void startLog(PandaDocument* doc);
 	void stopLog();
@@ -86,33 +116,94 @@ public:
 
 	void setNbThreads(int nbThreads);
 	int getNbThreads() const;
-	void setupThread(int id);
+	void setupThread(int id); /// Set the index of the calling thread
+	void setEventsCapacity(int capacity); /// Number of events kept for each thread during a log (only the last ones are kept)
 
 	const UpdateEvents getEvents(int id) const;
 	const NodeStates getInitialNodeStates() const;
 
+	/// Keep the events of the next nbFrames logs (even if the logger is disabled), then give them to the callback (called at the end of the last log)
+	void captureFrames(int nbFrames, CaptureCallback callback);
+	bool isCapturing() const;
+
 protected:
 	UpdateLogger();
 	friend class ScopedEvent;
 	friend class Scheduler;
 
-	void addEvent(EventData event);
+	void addEvent(const EventData& event);
 	int& logLevel(int threadId);
 
-	std::vector<UpdateEvents> m_events, m_prevEvents;
+	// Preallocated buffer where a single thread writes its events, overwriting the oldest ones when it is full
+	struct EventsRing
+	{
+		explicit EventsRing(int capacity) : events(capacity) {}
+
+		std::vector<EventData> events;
+		std::atomic<unsigned long long> written{ 0 }; // Total number of events added since the start of the log
+		int level = -1;
+	};
+	using EventsRingPtr = std::unique_ptr<EventsRing>;
+
+	void createRings();
+
+	std::vector<EventsRingPtr> m_rings;
+	std::vector<UpdateEvents> m_prevEvents;
 	int m_nbThreads;
-	bool m_logging;
+	int m_eventsCapacity;
+	bool m_enabled;
+	unsigned int m_eventsMask;
+	std::atomic_bool m_logging;
+	static std::atomic<unsigned int> s_recordedEvents; // The events mask during a log, 0 otherwise
 	NodeStates m_nodeStates, m_prevNodeStates;
-	std::vector<int> m_logLevelMap;
 	PandaDocument* m_document;
+
+	int m_nbFramesToCapture;
+	Frames m_capturedFrames;
+	CaptureCallback m_captureCallback;
 };
 
 inline int& UpdateLogger::logLevel(int threadId)
-{ return m_logLevelMap[threadId]; }
+{ return m_rings[threadId]->level; }
 
 inline int UpdateLogger::getNbThreads() const
 { return m_nbThreads; }
 
+inline bool UpdateLogger::isRecording(EventType type)
+{ return (s_recordedEvents.load(std::memory_order_relaxed) & eventBit(type)) != 0; }
+
+inline bool UpdateLogger::isEnabled() const
+{ return m_enabled; }
+
+inline unsigned int UpdateLogger::getEventsMask() const
+{ return m_eventsMask; }
+
+inline bool UpdateLogger::isCapturing() const
+{ return m_nbFramesToCapture > 0; }
+
+#ifdef PANDA_LOG_EVENTS
+
+inline ScopedEvent::ScopedEvent(EventType type, const PandaObject* object)
+	: m_active(UpdateLogger::isRecording(type))
+{ if(m_active) start(type, object); }
+
+inline ScopedEvent::ScopedEvent(EventType type, const BaseData* data)
+	: m_active(UpdateLogger::isRecording(type))
+{ if(m_active) start(type, data); }
+
+inline ScopedEvent::ScopedEvent(const char* text, DataNode* node)
+	: m_active(UpdateLogger::isRecording(event_custom))
+{ if(m_active) start(text, node); }
+
+inline ScopedEvent::ScopedEvent(const std::string& text, DataNode* node)
+	: m_active(UpdateLogger::isRecording(event_custom))
+{ if(m_active) start(text, node); }
+
+inline ScopedEvent::~ScopedEvent()
+{ if(m_active) stop(); }
+
+#endif // PANDA_LOG_EVENTS
+
 } // namespace helper
 
 } // namespace panda
@@ -249,20 +249,26 @@ void GenericObject::disconnectData(BaseData* data)
 
 std::vector<int> GenericObject::getRegisteredTypes()
 {
-	std::vector<int> keys;
-	keys.reserve(m_functions.size());
-	for (const auto& func : m_functions)
-		keys.push_back(func.first);
-	return keys;
+	return m_registeredTypes;
+}
+
+void GenericObject::registerFunction(int type, FuncPtr func)
+{
+	if (type < 0)
+		return;
+
+	if (type >= static_cast<int>(m_functions.size()))
+		m_functions.resize(type + 1);
+	if (m_functions[type]) // Already registered
+		return;
+	m_functions[type] = std::move(func);
+	m_registeredTypes.push_back(type);
 }
 
 void GenericObject::invokeFunction(int type, DataList& list)
 {
-	auto it = std::find_if(m_functions.begin(), m_functions.end(), [type](const TypeFuncPair& func){
-		return func.first == type;
-	});
-	if (it != m_functions.end())
-		it->second(list);
+	if (type >= 0 && type < static_cast<int>(m_functions.size()) && m_functions[type])
+		m_functions[type](list);
 }
 
 void GenericObject::save(XmlElement& elem, const std::vector<PandaObject*>* selected)
@@ -167,8 +167,9 @@ private:
 	void setupGenericData(BaseGenericData& data, const GenericDataDefinitionList& defList);
 
 	using FuncPtr = std::function<void(DataList&)>;
-	typedef std::pair<int, FuncPtr> TypeFuncPair;
-	std::vector<TypeFuncPair> m_functions;
+	std::vector<FuncPtr> m_functions; // Indexed by the type id (the types given to setupGenericObject are value types, so their ids are small)
+	std::vector<int> m_registeredTypes; // In the order of the types list
+	void registerFunction(int type, FuncPtr func);
 
 	template <class T>
 	struct functionCreatorWrapper
@@ -178,7 +179,7 @@ private:
 		{
 			int type = types::DataTypeId::getIdOf<U>();
 			auto obj = object;
-			object->m_functions.emplace_back(type, [obj](DataList& list) { obj->updateT<U>(list); });
+			object->registerFunction(type, [obj](DataList& list) { obj->updateT<U>(list); });
 		}
 
 		T* object;
@@ -2,6 +2,7 @@
 #include <panda/document/PandaDocument.h>
 #include <panda/XmlDocument.h>
 #include <panda/helper/algorithm.h>
+#include <panda/helper/Arena.h>
 #include <panda/helper/UpdateLogger.h>
 #include <panda/object/ObjectAddons.h>
 
@@ -9,12 +10,19 @@ namespace panda
 {
 
 PandaObject::PandaObject(PandaDocument* document)
-	: m_parentDocument(document)
+	: DataNode(NodeKind::Object)
+	, m_parentDocument(document)
 	, m_addons(std::make_unique<ObjectAddons>(*this))
 {
+	if(m_parentDocument)
+		m_parentDocument->assignNodeId(*this);
 }
 
-PandaObject::~PandaObject() = default;
+PandaObject::~PandaObject()
+{
+	if(m_parentDocument && m_parentDocument != this)
+		m_parentDocument->releaseNodeId(*this);
+}
 
 void PandaObject::addData(BaseData* data, int index)
 {
@@ -24,6 +32,8 @@ void PandaObject::addData(BaseData* data, int index)
 		m_datas.push_back(data);
 	else
 		m_datas.insert(m_datas.begin() + index, data);
+	if(m_parentDocument)
+		m_parentDocument->assignNodeId(*data);
 	emitModified();
 }
 
@@ -57,9 +67,12 @@ void PandaObject::update()
 
 void PandaObject::updateIfDirty() const
 {
-	if(isDirty() && !m_isUpdating)
+	// Only one thread updates the object, the other ones reading it wait until it is done.
+	// An object doing later updates can be read by the tasks it launched while updating, they must not wait for it.
+	if(isDirtyOrUpdating() && !m_destructing && beginUpdate(!m_laterUpdate))
 	{
 		helper::ScopedEvent log(helper::event_update, this);
+		helper::ArenaScope arenaScope; // Release the temporaries allocated during the update
 		m_isUpdating = true;
 
 		auto nonConstThis = const_cast<PandaObject*>(this);
@@ -67,6 +80,7 @@ void PandaObject::updateIfDirty() const
 		nonConstThis->cleanDirty(); // We force the dirty flag to be cleaned (otherwise the object will not be refreshed if an input changes)
 
 		m_isUpdating = false;
+		endUpdate();
 	}
 }
 
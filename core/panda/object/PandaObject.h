@@ -24,6 +24,7 @@ public:
 	virtual ~PandaObject();
 
 	const std::string& getName() const; /// Returns the name of the object (what is shown in the graph view)
+	helper::StringId getNameId() const; /// Id of the name in the string table
 	uint32_t getIndex() const; /// Returns the index of creation of this object (will not change during the life of the document)
 
 	void addData(BaseData* data, int index = -1); /// Insert a new Data at the specified index. If index < 0, add at the end
@@ -84,6 +85,8 @@ public:
 
 	virtual std::string getLabel() const; /// If not empty, will be shown in the graph view (with the format "label (name)")
 
+	virtual std::size_t getInternalHeapSize() const { return 0; } /// Memory kept by the object between steps outside of its Datas, for the memory statistics
+
 	ObjectAddons& addons() const; /// Get the addons for this object
 
 protected:
@@ -102,7 +105,7 @@ private:
 	PandaDocument* m_parentDocument = nullptr; // Pointer to the parent document
 	std::vector<BaseData*> m_datas; // The list of Datas added to this object (via the use of initData in a Data constructor or with addData)
 	uint32_t m_index = 0; // The unique index of this object. This is set automatically by the factory
-	std::string m_name; // The class name of this object. This is set automatically by the factory
+	helper::StringId m_name = 0; // The class name of this object, in the string table. This is set automatically by the factory
 	std::unique_ptr<ObjectAddons> m_addons; // Addons for this object
 
 	bool m_doEmitModified = true; // If false, prevent the emission of the modified signal
@@ -146,6 +149,9 @@ inline BaseData::BaseInitData PandaObject::initData(std::string name, std::strin
 { return BaseData::BaseInitData(name, help, this); }
 
 inline const std::string& PandaObject::getName() const
+{ return helper::internedString(m_name); }
+
+inline helper::StringId PandaObject::getNameId() const
 { return m_name; }
 
 inline uint32_t PandaObject::getIndex() const
@@ -161,7 +167,7 @@ inline const std::vector<BaseData*>& PandaObject::getDatas() const
 { return m_datas; }
 
 inline void PandaObject::setInternalData(const std::string& name, uint32_t index)
-{ m_name = name; m_index = index; }
+{ m_name = helper::internString(name); m_index = index; }
 
 inline bool PandaObject::doesLaterUpdate() const
 { return m_laterUpdate; }
@@ -209,6 +215,19 @@ inline DataNode::NodesList PandaObject::getNonRecursiveOutputs() const
 inline ObjectAddons& PandaObject::addons() const
 { return *m_addons.get(); }
 
+/// Faster alternatives to dynamic_cast, using the kind of the node
+inline PandaObject* asObject(DataNode* node)
+{ return node->nodeKind() == NodeKind::Object ? static_cast<PandaObject*>(node) : nullptr; }
+
+inline BaseData* asData(DataNode* node)
+{ return node->nodeKind() == NodeKind::Data ? static_cast<BaseData*>(node) : nullptr; }
+
+inline const PandaObject* asObject(const DataNode* node)
+{ return node->nodeKind() == NodeKind::Object ? static_cast<const PandaObject*>(node) : nullptr; }
+
+inline const BaseData* asData(const DataNode* node)
+{ return node->nodeKind() == NodeKind::Data ? static_cast<const BaseData*>(node) : nullptr; }
+
 } // namespace Panda
 
 #endif // PANDAOBJECT_H
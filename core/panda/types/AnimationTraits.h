@@ -30,8 +30,8 @@ public:
 	static std::string typeName() { return base_trait::typeName() + "_animation"; }
 	static std::string typeDescription() { return "animation of " + valueTypeNamePlural(); }
 	static const std::type_info& typeInfo() { return typeid(animation_type); }
-	static int valueTypeId() { return DataTypeId::getIdOf<value_type>(); }
-	static int fullTypeId() { return DataTypeId::getFullTypeOfAnimation(valueTypeId()); }
+	static int valueTypeId() { return base_trait::valueTypeId(); }
+	static int fullTypeId() { static const int id = DataTypeId::getFullTypeOfAnimation(valueTypeId()); return id; }
 	static unsigned int typeColor() { return base_trait::typeColor(); }
 	static int size(const animation_type& a) { return a.size(); }
 	static void clear(animation_type& a, int /*size*/, bool /*init*/) { a.clear(); }
@@ -72,6 +72,25 @@ public:
 			anim.add(key, val);
 		}
 	}
+	static bool hashValue(const animation_type& anim, std::size_t& hash)
+	{
+		hashCombine(hash, static_cast<std::size_t>(anim.extend()));
+		hashCombine(hash, static_cast<std::size_t>(anim.interpolation()));
+		for(const auto& stop : anim.stops())
+		{
+			hashCombine(hash, std::hash<float>()(stop.first));
+			if(!base_trait::hashValue(stop.second, hash))
+				return false;
+		}
+		return true;
+	}
+	static std::size_t heapSize(const animation_type& anim)
+	{
+		std::size_t size = vectorHeapSize(anim.stops());
+		for(const auto& stop : anim.stops())
+			size += base_trait::heapSize(stop.second);
+		return size;
+	}
 };
 
 } // namespace types
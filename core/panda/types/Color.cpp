@@ -148,6 +148,14 @@ PANDA_CORE_API void DataTrait<Color>::readValue(const XmlElement& elem, Color& v
 	v = c.bounded();
 }
 
+template<>
+PANDA_CORE_API bool DataTrait<Color>::hashValue(const Color& v, std::size_t& hash)
+{
+	for(float f : { v.r, v.g, v.b, v.a })
+		hashCombine(hash, std::hash<float>()(f));
+	return true;
+}
+
 //****************************************************************************//
 
 template class PANDA_CORE_API Animation<Color>;
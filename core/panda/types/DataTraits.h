@@ -5,6 +5,8 @@
 #include <panda/types/DataTypeId.h>
 #include <panda/XmlDocument.h>
 
+#include <functional>
+#include <type_traits>
 #include <vector>
 
 namespace panda
@@ -13,6 +15,18 @@ namespace panda
 namespace types
 {
 
+class Color;
+class FloatVector;
+class Gradient;
+class ImageWrapper;
+class IntVector;
+class Mesh;
+class Path;
+class Point;
+class Polygon;
+class Rect;
+class Shader;
+
 class PANDA_CORE_API AbstractDataTrait
 {
 public:
@@ -41,14 +55,36 @@ public:
 
 	virtual void writeValue(XmlElement& elem, const void* value) const = 0; /// Save the value to XML
 	virtual void readValue(const XmlElement& elem, void* value) const = 0;		/// Load the value from XML
+
+	virtual bool hashValue(const void* value, std::size_t& hash) const = 0;	/// Combine the value into the hash, returns false if this type cannot be hashed
+	virtual std::size_t heapSize(const void* value) const = 0;					/// Memory allocated by the value, in bytes (not counting sizeof the value itself)
 };
 
 //****************************************************************************//
 
+inline void hashCombine(std::size_t& seed, std::size_t value)
+{ seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2); }
+
+template<class T>
+bool hashArithmetic(const T& v, std::size_t& hash, std::true_type)
+{ hashCombine(hash, std::hash<T>()(v)); return true; }
+
+template<class T>
+bool hashArithmetic(const T&, std::size_t&, std::false_type)
+{ return false; }
+
+template<class T>
+std::size_t vectorHeapSize(const std::vector<T>& vec) /// Only the buffer, not the memory allocated by the elements
+{ return vec.capacity() * sizeof(T); }
+
+//****************************************************************************//
+
 /*
  * Class used to describe a type
  * 4 functions have to be written for each type:
  *   valueTypeName, writeValue & readValue
+ * hashValue can be specialized, it is only used to detect unchanged values
+ * heapSize must be specialized for types allocating memory, it is used for the memory statistics
  */
 template<class T>
 class DataTrait
@@ -74,14 +110,42 @@ public:
 	static std::string typeName() { return valueTypeName(); }
 	static std::string typeDescription() { return valueTypeName() + " value"; }
 	static const std::type_info& typeInfo() { return typeid(T); }
-	static int valueTypeId() { return DataTypeId::getIdOf<value_type>(); }
-	static int fullTypeId() { return DataTypeId::getFullTypeOfSingleValue(valueTypeId()); }
+	static int valueTypeId() { static const int id = DataTypeId::getIdOf<value_type>(); return id; }
+	static int fullTypeId() { static const int id = DataTypeId::getFullTypeOfSingleValue(valueTypeId()); return id; }
 	static int size(const value_type& /*v*/) { return 1; }
 	static void clear(value_type& v, int /*size*/, bool init) { if(init) v = T(); }
 	static const void* getVoidValue(const value_type& v, int /*index*/) { return &v; }
 	static void* getVoidValue(value_type& v, int /*index*/) { return &v; }
+	static bool hashValue(const value_type& v, std::size_t& hash) { return hashArithmetic(v, hash, std::is_arithmetic<T>()); }
+	static std::size_t heapSize(const value_type& /*v*/) { return 0; }
 };
 
+template<> inline bool DataTrait<std::string>::hashValue(const std::string& v, std::size_t& hash)
+{ hashCombine(hash, std::hash<std::string>()(v)); return true; }
+
+template<> inline std::size_t DataTrait<std::string>::heapSize(const std::string& v)
+{
+	const char* begin = reinterpret_cast<const char*>(&v);
+	const bool local = v.data() >= begin && v.data() < begin + sizeof(v); // Short strings are stored inside the object
+	return local ? 0 : v.capacity() + 1;
+}
+
+template<> PANDA_CORE_API bool DataTrait<Color>::hashValue(const Color& v, std::size_t& hash);
+template<> PANDA_CORE_API bool DataTrait<FloatVector>::hashValue(const FloatVector& v, std::size_t& hash);
+template<> PANDA_CORE_API bool DataTrait<IntVector>::hashValue(const IntVector& v, std::size_t& hash);
+template<> PANDA_CORE_API bool DataTrait<Path>::hashValue(const Path& v, std::size_t& hash);
+template<> PANDA_CORE_API bool DataTrait<Point>::hashValue(const Point& v, std::size_t& hash);
+template<> PANDA_CORE_API bool DataTrait<Rect>::hashValue(const Rect& v, std::size_t& hash);
+
+template<> PANDA_CORE_API std::size_t DataTrait<FloatVector>::heapSize(const FloatVector& v);
+template<> PANDA_CORE_API std::size_t DataTrait<Gradient>::heapSize(const Gradient& v);
+template<> PANDA_CORE_API std::size_t DataTrait<ImageWrapper>::heapSize(const ImageWrapper& v);
+template<> PANDA_CORE_API std::size_t DataTrait<IntVector>::heapSize(const IntVector& v);
+template<> PANDA_CORE_API std::size_t DataTrait<Mesh>::heapSize(const Mesh& v);
+template<> PANDA_CORE_API std::size_t DataTrait<Path>::heapSize(const Path& v);
+template<> PANDA_CORE_API std::size_t DataTrait<Polygon>::heapSize(const Polygon& v);
+template<> PANDA_CORE_API std::size_t DataTrait<Shader>::heapSize(const Shader& v);
+
 //****************************************************************************//
 
 template<class T>
@@ -126,6 +190,11 @@ public:
 	{ return value_trait::writeValue(elem, *static_cast<const value_type*>(value)); }
 	virtual void readValue(const XmlElement& elem, void* value) const
 	{ return value_trait::readValue(elem, *static_cast<value_type*>(value)); }
+
+	virtual bool hashValue(const void* value, std::size_t& hash) const
+	{ return value_trait::hashValue(*static_cast<const value_type*>(value), hash); }
+	virtual std::size_t heapSize(const void* value) const
+	{ return value_trait::heapSize(*static_cast<const value_type*>(value)); }
 };
 
 //****************************************************************************//
@@ -150,8 +219,8 @@ public:
 	static std::string typeName() { return base_trait::typeName() + "_vector"; }
 	static std::string typeDescription() { return "vector of " + valueTypeNamePlural(); }
 	static const std::type_info& typeInfo() { return typeid(vector_type); }
-	static int valueTypeId() { return DataTypeId::getIdOf<value_type>(); }
-	static int fullTypeId() { return DataTypeId::getFullTypeOfVector(valueTypeId()); }
+	static int valueTypeId() { return base_trait::valueTypeId(); }
+	static int fullTypeId() { static const int id = DataTypeId::getFullTypeOfVector(valueTypeId()); return id; }
 	static unsigned int typeColor() { return base_trait::typeColor(); }
 	static int size(const vector_type& v) { return v.size(); }
 	static void clear(vector_type& v, int size, bool init)
@@ -190,6 +259,23 @@ public:
 			vec.push_back(t);
 		}
 	}
+	static bool hashValue(const vector_type& vec, std::size_t& hash)
+	{
+		hashCombine(hash, vec.size());
+		for (const auto& v : vec)
+		{
+			if (!base_trait::hashValue(v, hash))
+				return false;
+		}
+		return true;
+	}
+	static std::size_t heapSize(const vector_type& vec)
+	{
+		std::size_t size = vectorHeapSize(vec);
+		for (const auto& v : vec)
+			size += base_trait::heapSize(v);
+		return size;
+	}
 };
 
 //****************************************************************************//
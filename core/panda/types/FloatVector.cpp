@@ -100,6 +100,18 @@ namespace types
 		}
 	}
 
+	template<>
+	PANDA_CORE_API bool DataTrait<FloatVector>::hashValue(const FloatVector& floats, std::size_t& hash)
+	{
+		return DataTrait<std::vector<float>>::hashValue(floats.values, hash);
+	}
+
+	template<>
+	PANDA_CORE_API std::size_t DataTrait<FloatVector>::heapSize(const FloatVector& floats)
+	{
+		return vectorHeapSize(floats.values);
+	}
+
 } // namespace types
 
 template class PANDA_CORE_API Data<types::FloatVector>;
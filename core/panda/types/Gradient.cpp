@@ -185,6 +185,12 @@ PANDA_CORE_API void DataTrait<Gradient>::readValue(const XmlElement& elem, Gradi
 	}
 }
 
+template<>
+PANDA_CORE_API std::size_t DataTrait<Gradient>::heapSize(const Gradient& grad)
+{
+	return vectorHeapSize(grad.stops());
+}
+
 template<>
 Gradient interpolate(const Gradient& g1, const Gradient& g2, float amt)
 { return Gradient::interpolate(g1, g2, amt); }
@@ -163,6 +163,14 @@ bool ImageWrapper::operator!=(const ImageWrapper& img) const
 	return !(*this == img);
 }
 
+std::size_t ImageWrapper::heapSize() const
+{
+	std::size_t size = vectorHeapSize(m_buffer);
+	if (m_image)
+		size += static_cast<std::size_t>(m_image->width()) * m_image->height() * 4;
+	return size;
+}
+
 //****************************************************************************//
 
 template<> PANDA_CORE_API std::string DataTrait<ImageWrapper>::valueTypeName() { return "image"; }
@@ -174,6 +182,8 @@ template<> PANDA_CORE_API void DataTrait<ImageWrapper>::readValue(const XmlEleme
 template<> PANDA_CORE_API bool DataTrait<ImageWrapper>::isDisplayed() { return false; }
 template<> PANDA_CORE_API bool DataTrait<ImageWrapper>::isPersistent() { return false; }
 
+template<> PANDA_CORE_API std::size_t DataTrait<ImageWrapper>::heapSize(const ImageWrapper& v) { return v.heapSize(); }
+
 } // namespace types
 
 template class PANDA_CORE_API Data<types::ImageWrapper>;
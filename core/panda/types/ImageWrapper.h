@@ -51,6 +51,8 @@ public:
 
 	graphics::Framebuffer* getFbo() const; /// Will return null if image source
 
+	std::size_t heapSize() const; /// Memory used by the image and the buffer (the textures are in the graphics memory and not counted)
+
 	bool operator==(const ImageWrapper& img) const;
 	bool operator!=(const ImageWrapper& img) const;
 
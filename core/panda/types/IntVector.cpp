@@ -99,6 +99,18 @@ namespace types
 		}
 	}
 
+	template<>
+	PANDA_CORE_API bool DataTrait<IntVector>::hashValue(const IntVector& ints, std::size_t& hash)
+	{
+		return DataTrait<std::vector<int>>::hashValue(ints.values, hash);
+	}
+
+	template<>
+	PANDA_CORE_API std::size_t DataTrait<IntVector>::heapSize(const IntVector& ints)
+	{
+		return vectorHeapSize(ints.values);
+	}
+
 } // namespace types
 
 template class PANDA_CORE_API Data<types::IntVector>;
@@ -561,6 +561,20 @@ void Mesh::clear()
 	clearBorderElementLists();
 }
 
+std::size_t Mesh::heapSize() const
+{
+	std::size_t size = vectorHeapSize(m_points) + vectorHeapSize(m_edges) + vectorHeapSize(m_triangles)
+		+ vectorHeapSize(m_edgesInTriangle) + vectorHeapSize(m_pointsOnBorder)
+		+ vectorHeapSize(m_edgesOnBorder) + vectorHeapSize(m_trianglesOnBorder);
+	for (const auto* lists : { &m_edgesAroundPoint, &m_trianglesAroundPoint, &m_trianglesAroundEdge })
+	{
+		size += vectorHeapSize(*lists);
+		for (const auto& list : *lists)
+			size += vectorHeapSize(list);
+	}
+	return size;
+}
+
 //****************************************************************************//
 
 void translate(Mesh& mesh, const Point& delta)
@@ -680,6 +694,12 @@ PANDA_CORE_API void DataTrait<Mesh>::readValue(const XmlElement& elem, Mesh& v)
 	v = std::move(tmpMesh);
 }
 
+template<>
+PANDA_CORE_API std::size_t DataTrait<Mesh>::heapSize(const Mesh& v)
+{
+	return v.heapSize();
+}
+
 } // namespace types
 
 template class PANDA_CORE_API Data<types::Mesh>;
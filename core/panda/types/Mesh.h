@@ -128,6 +128,8 @@ public:
 	void clearBorderElementLists();
 	void clear();
 
+	std::size_t heapSize() const; /// Memory used by all the lists, including the ones created on demand
+
 	bool operator==(const Mesh& mesh) const;
 	bool operator!=(const Mesh& mesh) const;
 
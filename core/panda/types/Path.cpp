@@ -234,6 +234,18 @@ PANDA_CORE_API void DataTrait<Path>::readValue(const XmlElement& elem, Path& pat
 	}
 }
 
+template<>
+PANDA_CORE_API bool DataTrait<Path>::hashValue(const Path& path, std::size_t& hash)
+{
+	return DataTrait<std::vector<Point>>::hashValue(path.points, hash);
+}
+
+template<>
+PANDA_CORE_API std::size_t DataTrait<Path>::heapSize(const Path& path)
+{
+	return vectorHeapSize(path.points);
+}
+
 } // namespace types
 
 template class PANDA_CORE_API Data<types::Path>;
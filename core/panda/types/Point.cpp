@@ -70,6 +70,12 @@ PANDA_CORE_API void DataTrait<Point>::readValue(const XmlElement& elem, Point& v
 {	v.x = elem.attribute("x").toFloat();
 	v.y = elem.attribute("y").toFloat(); }
 
+template<>
+PANDA_CORE_API bool DataTrait<Point>::hashValue(const Point& v, std::size_t& hash)
+{	hashCombine(hash, std::hash<float>()(v.x));
+	hashCombine(hash, std::hash<float>()(v.y));
+	return true; }
+
 } // namespace types
 
 //template class PANDA_CORE_API std::vector<types::Point>;
@@ -100,6 +100,12 @@ PANDA_CORE_API void DataTrait<Polygon>::readValue(const XmlElement& elem, Polygo
 	}
 }
 
+template<>
+PANDA_CORE_API std::size_t DataTrait<Polygon>::heapSize(const Polygon& poly)
+{
+	return DataTrait<Path>::heapSize(poly.contour) + DataTrait<std::vector<Path>>::heapSize(poly.holes);
+}
+
 } // namespace types
 
 template class PANDA_CORE_API Data<types::Polygon>;
@@ -83,6 +83,14 @@ PANDA_CORE_API void DataTrait<Rect>::readValue(const XmlElement& elem, Rect& v)
 	v.setBottom(elem.attribute("b").toFloat());
 }
 
+template<>
+PANDA_CORE_API bool DataTrait<Rect>::hashValue(const Rect& v, std::size_t& hash)
+{
+	for(float f : { v.x1, v.y1, v.x2, v.y2 })
+		hashCombine(hash, std::hash<float>()(f));
+	return true;
+}
+
 template class PANDA_CORE_API Data< Rect >;
 template class PANDA_CORE_API Data< std::vector<Rect> >;
 
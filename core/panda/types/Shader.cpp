@@ -156,6 +156,16 @@ bool Shader::operator==(const Shader& shader) const
 		&& m_customTextures == shader.m_customTextures;
 }
 
+std::size_t Shader::heapSize() const
+{
+	std::size_t size = vectorHeapSize(m_shaderValues) + vectorHeapSize(m_customTextures);
+	for (const auto& source : m_sourcesMap)
+		size += sizeof(source) + DataTrait<std::string>::heapSize(source.second.sourceCode);
+	for (const auto& value : m_shaderValues)
+		size += DataTrait<std::string>::heapSize(value->getName()) + value->dataTrait()->heapSize(value->getValue());
+	return size;
+}
+
 bool Shader::operator!=(const Shader& shader) const
 {
 	return !(*this == shader);
@@ -248,6 +258,12 @@ PANDA_CORE_API void DataTrait<Shader>::readValue(const XmlElement& elem, Shader&
 	}
 }
 
+template<>
+PANDA_CORE_API std::size_t DataTrait<Shader>::heapSize(const Shader& v)
+{
+	return v.heapSize();
+}
+
 //****************************************************************************//
 
 } // namespace types
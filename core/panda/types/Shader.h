@@ -119,6 +119,8 @@ public:
 	bool operator==(const Shader& s) const;
 	bool operator!=(const Shader& s) const;
 
+	std::size_t heapSize() const; /// Memory used by the sources and the values
+
 protected:
 	typedef std::map<ShaderType, ShaderSource> SourcesMap;
 	SourcesMap m_sourcesMap;
@@ -25,16 +25,22 @@ bool TypeConverter::canConvert(int fromType, int toType)
 }
 
 void TypeConverter::convert(int fromType, int toType, const void* valueFrom, void* valueTo)
+{
+	auto functor = getConverter(fromType, toType);
+	if(functor)
+		functor->convert(valueFrom, valueTo);
+}
+
+const BaseConverterFunctor* TypeConverter::getConverter(int fromType, int toType)
 {
 	const FunctorMap& map1 = getFunctorMap();
-	if(!map1.count(fromType))
-		return;
-	const auto& map2 = map1.at(fromType);
-	if(!map2.count(toType))
-		return;
-
-	auto functor = map2.at(toType);
-	functor->convert(valueFrom, valueTo);
+	auto it1 = map1.find(fromType);
+	if(it1 == map1.end())
+		return nullptr;
+	auto it2 = it1->second.find(toType);
+	if(it2 == it1->second.end())
+		return nullptr;
+	return it2->second.get();
 }
 
 void TypeConverter::registerFunctor(int fromType, int toType, FunctorPtr ptr)
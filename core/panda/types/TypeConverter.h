@@ -20,6 +20,7 @@ class BaseConverterFunctor
 {
 public:
 	virtual void convert(const void* valueFrom, void* valueTo) const = 0;
+	virtual void convertArray(const void* valuesFrom, void* valuesTo, int count) const = 0; /// Convert count contiguous values
 };
 
 class PANDA_CORE_API TypeConverter
@@ -27,6 +28,7 @@ class PANDA_CORE_API TypeConverter
 public:
 	static bool canConvert(int fromType, int toType);
 	static void convert(int fromType, int toType, const void* valueFrom, void* valueTo);
+	static const BaseConverterFunctor* getConverter(int fromType, int toType); /// Returns null if there is no conversion (can be kept to convert many values)
 
 	typedef std::shared_ptr<BaseConverterFunctor> FunctorPtr;
 private:
@@ -46,6 +48,13 @@ public:
 	{
 		(*convertFunction)(*static_cast<const From*>(valueFrom), *static_cast<To*>(valueTo));
 	}
+	virtual void convertArray(const void* valuesFrom, void* valuesTo, int count) const
+	{
+		const From* from = static_cast<const From*>(valuesFrom);
+		To* to = static_cast<To*>(valuesTo);
+		for(int i = 0; i < count; ++i)
+			(*convertFunction)(from[i], to[i]);
+	}
 
 private:
 	convertTypeFunc* convertFunction;
@@ -59,6 +68,13 @@ public:
 	{
 		::convertType(*static_cast<const From*>(valueFrom), *static_cast<To*>(valueTo));
 	}
+	virtual void convertArray(const void* valuesFrom, void* valuesTo, int count) const
+	{ // Instantiated where the converter is registered, so convertType can be inlined there
+		const From* from = static_cast<const From*>(valuesFrom);
+		To* to = static_cast<To*>(valuesTo);
+		for(int i = 0; i < count; ++i)
+			::convertType(from[i], to[i]);
+	}
 };
 
 template<class From, class To>
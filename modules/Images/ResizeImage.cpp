@@ -1,4 +1,5 @@
 #include <panda/object/ObjectFactory.h>
+#include <panda/helper/Parallel.h>
 #include <panda/types/Point.h>
 
 #include <modules/Images/utils.h>
@@ -47,26 +48,36 @@ public:
 			outputList.resize(nbI);
 			if (nbS < nbI) nbS = 1;
 
+			// Getting the images and releasing the previous textures need the OpenGL context, so it is done on this thread
+			std::vector<const graphics::Image*> images;
+			images.reserve(nbI);
 			for (int i = 0; i < nbI; ++i)
 			{
-				const auto& input = inputList[i].getImage();
-				const auto& size = sizeList[i % nbS];
-				auto& output = outputList[i];
-				auto dib = convertFromImage(input);
-
-				int dw = static_cast<int>(size.x), dh = static_cast<int>(size.y);
-
-				auto resized = FreeImage_Rescale(dib, dw, dh, filter);
-				FreeImage_Unload(dib);
+				images.push_back(&inputList[i].getImage());
+				outputList[i].clear();
+			}
 
-				if (resized)
+			helper::parallelFor(parentDocument(), nbI, [&](int begin, int end) {
+				for (int i = begin; i < end; ++i)
 				{
-					output.setImage(convertToImage(resized));
-					FreeImage_Unload(resized);
+					const auto& size = sizeList[i % nbS];
+					auto& output = outputList[i];
+					auto dib = convertFromImage(*images[i]);
+
+					int dw = static_cast<int>(size.x), dh = static_cast<int>(size.y);
+
+					auto resized = FreeImage_Rescale(dib, dw, dh, filter);
+					FreeImage_Unload(dib);
+
+					if (resized)
+					{
+						output.setImage(convertToImage(resized));
+						FreeImage_Unload(resized);
+					}
+					else
+						output.clear();
 				}
-				else
-					output.clear();
-			}
+			}, 1);
 		}
 		else
 			outputList.clear();
@@ -40,9 +40,9 @@ public:
 	void updateT(DataList& list)
 	{
 		typedef Data< std::vector<T> > ListData;
-		ListData* dataInTrue = dynamic_cast<ListData*>(list[0]);
-		ListData* dataInFalse = dynamic_cast<ListData*>(list[1]);
-		ListData* dataOutput = dynamic_cast<ListData*>(list[2]);
+		ListData* dataInTrue = data_cast<ListData>(list[0]);
+		ListData* dataInFalse = data_cast<ListData>(list[1]);
+		ListData* dataOutput = data_cast<ListData>(list[2]);
 
 		assert(dataInTrue && dataInFalse && dataOutput);
 
@@ -34,7 +34,7 @@ public:
 	{
 		typedef Data<int> IntData;
 		BaseData* dataInput = list[0];
-		IntData* dataCounter = dynamic_cast<IntData*>(list[1]);
+		IntData* dataCounter = data_cast<IntData>(list[1]);
 		assert(dataInput && dataCounter);
 
 		dataCounter->setValue(dataInput->getCounter());
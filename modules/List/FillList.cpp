@@ -36,8 +36,8 @@ public:
 	{
 		int outputSize = size.getValue();
 		typedef Data< std::vector<T> > VecData;
-		VecData* dataInput = dynamic_cast<VecData*>(list[0]);
-		VecData* dataOutput = dynamic_cast<VecData*>(list[1]);
+		VecData* dataInput = data_cast<VecData>(list[0]);
+		VecData* dataOutput = data_cast<VecData>(list[1]);
 		assert(dataInput && dataOutput);
 
 		const std::vector<T>& inVal = dataInput->getValue();
@@ -40,9 +40,9 @@ public:
 	{
 		typedef Data< std::vector<T> > VecData;
 		typedef Data< std::vector<int> > VecIntData;
-		VecData* dataInput = dynamic_cast<VecData*>(list[0]);
-		VecData* dataValues = dynamic_cast<VecData*>(list[1]);
-		VecIntData* dataOutput = dynamic_cast<VecIntData*>(list[2]);
+		VecData* dataInput = data_cast<VecData>(list[0]);
+		VecData* dataValues = data_cast<VecData>(list[1]);
+		VecIntData* dataOutput = data_cast<VecIntData>(list[2]);
 		assert(dataInput && dataValues && dataOutput);
 
 		const std::vector<T>& inList = dataInput->getValue();
@@ -45,8 +45,8 @@ public:
 	void updateT(DataList& list)
 	{
 		typedef Data< std::vector<T> > ListData;
-		ListData* dataInput = dynamic_cast<ListData*>(list[0]);
-		ListData* dataOutput = dynamic_cast<ListData*>(list[1]);
+		ListData* dataInput = data_cast<ListData>(list[0]);
+		ListData* dataOutput = data_cast<ListData>(list[1]);
 
 		assert(dataInput && dataOutput);
 
@@ -58,7 +58,7 @@ public:
 		{
 			std::vector<const std::vector<T>*> inputsList;
 			for(auto baseDataInput : baseDataInputs)
-				inputsList.push_back(&dynamic_cast<ListData*>(baseDataInput)->getValue());
+				inputsList.push_back(&data_cast<ListData>(baseDataInput)->getValue());
 
 			int nb = inputsList.size();
 			int minSize = inputsList[0]->size();
@@ -56,9 +56,9 @@ public:
 	void updateT(DataList& list)
 	{
 		typedef Data< std::vector<T> > VecData;
-		VecData* dataInput = dynamic_cast<VecData*>(list[0]);
-		VecData* dataInit = dynamic_cast<VecData*>(list[1]);
-		VecData* dataOutput = dynamic_cast<VecData*>(list[2]);
+		VecData* dataInput = data_cast<VecData>(list[0]);
+		VecData* dataInit = data_cast<VecData>(list[1]);
+		VecData* dataOutput = data_cast<VecData>(list[2]);
 		assert(dataInput && dataInit && dataOutput);
 
 		const std::vector<T>& value = resetValues ? dataInit->getValue() : dataInput->getValue();
@@ -41,9 +41,9 @@ public:
 	{
 		using ValVecData = Data<std::vector<T>>;
 		using IntData = Data<int>;
-		auto dataInputA = dynamic_cast<ValVecData*>(list[0]);
-		auto dataInputB = dynamic_cast<ValVecData*>(list[1]);
-		auto dataOutput = dynamic_cast<IntData*>(list[2]);
+		auto dataInputA = data_cast<ValVecData>(list[0]);
+		auto dataInputB = data_cast<ValVecData>(list[1]);
+		auto dataOutput = data_cast<IntData>(list[2]);
 
 		assert(dataInputA && dataInputB && dataOutput);
 
@@ -93,9 +93,9 @@ public:
 	{
 		using ValVecData = Data<std::vector<T>>;
 		using IntVecData = Data<std::vector<int>>;
-		auto dataInputA = dynamic_cast<ValVecData*>(list[0]);
-		auto dataInputB = dynamic_cast<ValVecData*>(list[1]);
-		auto dataOutput = dynamic_cast<IntVecData*>(list[2]);
+		auto dataInputA = data_cast<ValVecData>(list[0]);
+		auto dataInputB = data_cast<ValVecData>(list[1]);
+		auto dataOutput = data_cast<IntVecData>(list[2]);
 
 		assert(dataInputA && dataInputB && dataOutput);
 
@@ -164,9 +164,9 @@ public:
 		using ValVecData = Data<ValVec>;
 		using VecIntVec = std::vector<IntVector>;
 		using VecIntVecData = Data<VecIntVec>;
-		auto dataInputA = dynamic_cast<ValVecData*>(list[0]);
-		auto dataInputB = dynamic_cast<ValVecData*>(list[1]);
-		auto dataOutput = dynamic_cast<VecIntVecData*>(list[2]);
+		auto dataInputA = data_cast<ValVecData>(list[0]);
+		auto dataInputB = data_cast<ValVecData>(list[1]);
+		auto dataOutput = data_cast<VecIntVecData>(list[2]);
 
 		assert(dataInputA && dataInputB && dataOutput);
 
@@ -248,9 +248,9 @@ public:
 		using ValVecData = Data<ValVec>;
 		using VecInt = std::vector<int>;
 		using VecIntData = Data<VecInt>;
-		auto dataInputA = dynamic_cast<ValVecData*>(list[0]);
-		auto dataInputB = dynamic_cast<ValVecData*>(list[1]);
-		auto dataOutput = dynamic_cast<VecIntData*>(list[2]);
+		auto dataInputA = data_cast<ValVecData>(list[0]);
+		auto dataInputB = data_cast<ValVecData>(list[1]);
+		auto dataOutput = data_cast<VecIntData>(list[2]);
 
 		assert(dataInputA && dataInputB && dataOutput);
 
@@ -43,9 +43,9 @@ public:
 		using ValVecData = Data<ValVec>;
 		using ValData = Data<T>;
 		using IntData = Data<int>;
-		auto dataInput = dynamic_cast<ValVecData*>(list[0]);
-		auto dataOutputValue = dynamic_cast<ValData*>(list[1]);
-		auto dataOutputIndex = dynamic_cast<IntData*>(list[2]);
+		auto dataInput = data_cast<ValVecData>(list[0]);
+		auto dataOutputValue = data_cast<ValData>(list[1]);
+		auto dataOutputIndex = data_cast<IntData>(list[2]);
 
 		assert(dataInput && dataOutputValue && dataOutputIndex);
 
@@ -116,9 +116,9 @@ public:
 		using ValVecData = Data<ValVec>;
 		using ValData = Data<T>;
 		using IntData = Data<int>;
-		auto dataInput = dynamic_cast<ValVecData*>(list[0]);
-		auto dataOutputValue = dynamic_cast<ValData*>(list[1]);
-		auto dataOutputIndex = dynamic_cast<IntData*>(list[2]);
+		auto dataInput = data_cast<ValVecData>(list[0]);
+		auto dataOutputValue = data_cast<ValData>(list[1]);
+		auto dataOutputIndex = data_cast<IntData>(list[2]);
 
 		assert(dataInput && dataOutputValue && dataOutputIndex);
 
@@ -191,9 +191,9 @@ public:
 		using ValData = Data<T>;
 		using VecInt = std::vector<int>;
 		using VecIntData = Data<VecInt>;
-		auto dataInput = dynamic_cast<ValVecData*>(list[0]);
-		auto dataOutputValue = dynamic_cast<ValData*>(list[1]);
-		auto dataOutputIndex = dynamic_cast<VecIntData*>(list[2]);
+		auto dataInput = data_cast<ValVecData>(list[0]);
+		auto dataOutputValue = data_cast<ValData>(list[1]);
+		auto dataOutputIndex = data_cast<VecIntData>(list[2]);
 
 		assert(dataInput && dataOutputValue && dataOutputIndex);
 
@@ -279,9 +279,9 @@ public:
 		using ValData = Data<T>;
 		using VecInt = std::vector<int>;
 		using VecIntData = Data<VecInt>;
-		auto dataInput = dynamic_cast<ValVecData*>(list[0]);
-		auto dataOutputValue = dynamic_cast<ValData*>(list[1]);
-		auto dataOutputIndex = dynamic_cast<VecIntData*>(list[2]);
+		auto dataInput = data_cast<ValVecData>(list[0]);
+		auto dataOutputValue = data_cast<ValData>(list[1]);
+		auto dataOutputIndex = data_cast<VecIntData>(list[2]);
 
 		assert(dataInput && dataOutputValue && dataOutputIndex);
 
@@ -371,10 +371,10 @@ public:
 		using ValVecData = Data<ValVec>;
 		using VecInt = std::vector<int>;
 		using VecIntData = Data<VecInt>;
-		auto dataInput = dynamic_cast<ValVecData*>(list[0]);
-		auto dataOutputValue = dynamic_cast<ValVecData*>(list[1]);
-		auto dataOutputIndex = dynamic_cast<VecIntData*>(list[2]);
-		auto dataOutputPosition = dynamic_cast<VecIntData*>(list[3]);
+		auto dataInput = data_cast<ValVecData>(list[0]);
+		auto dataOutputValue = data_cast<ValVecData>(list[1]);
+		auto dataOutputIndex = data_cast<VecIntData>(list[2]);
+		auto dataOutputPosition = data_cast<VecIntData>(list[3]);
 
 		assert(dataInput && dataOutputValue && dataOutputIndex && dataOutputPosition);
 
@@ -475,10 +475,10 @@ public:
 		using ValVecData = Data<ValVec>;
 		using VecInt = std::vector<int>;
 		using VecIntData = Data<VecInt>;
-		auto dataInput = dynamic_cast<ValVecData*>(list[0]);
-		auto dataOutputValue = dynamic_cast<ValVecData*>(list[1]);
-		auto dataOutputIndex = dynamic_cast<VecIntData*>(list[2]);
-		auto dataOutputPosition = dynamic_cast<VecIntData*>(list[3]);
+		auto dataInput = data_cast<ValVecData>(list[0]);
+		auto dataOutputValue = data_cast<ValVecData>(list[1]);
+		auto dataOutputIndex = data_cast<VecIntData>(list[2]);
+		auto dataOutputPosition = data_cast<VecIntData>(list[3]);
 
 		assert(dataInput && dataOutputValue && dataOutputIndex && dataOutputPosition);
 
@@ -36,8 +36,8 @@ public:
 	{
 		typedef Data< std::vector<T> > ListData;
 		typedef Data< int > IntData;
-		ListData* dataInput = dynamic_cast<ListData*>(list[0]);
-		IntData* dataSize = dynamic_cast<IntData*>(list[1]);
+		ListData* dataInput = data_cast<ListData>(list[0]);
+		IntData* dataSize = data_cast<IntData>(list[1]);
 
 		assert(dataInput && dataSize);
 
@@ -83,8 +83,8 @@ public:
 	{
 		typedef Data< std::vector<T> > ListData;
 		typedef Data< std::vector<int> > IntData;
-		ListData* dataInput = dynamic_cast<ListData*>(list[0]);
-		IntData* dataSize = dynamic_cast<IntData*>(list[1]);
+		ListData* dataInput = data_cast<ListData>(list[0]);
+		IntData* dataSize = data_cast<IntData>(list[1]);
 
 		assert(dataInput && dataSize);
 
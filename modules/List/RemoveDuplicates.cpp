@@ -83,8 +83,8 @@ public:
 	void updateT(DataList& list)
 	{
 		typedef Data< std::vector<T> > ListData;
-		ListData* dataInput = dynamic_cast<ListData*>(list[0]);
-		ListData* dataOutput = dynamic_cast<ListData*>(list[1]);
+		ListData* dataInput = data_cast<ListData>(list[0]);
+		ListData* dataOutput = data_cast<ListData>(list[1]);
 
 		assert(dataInput && dataOutput);
 
@@ -42,9 +42,9 @@ public:
 	{
 		typedef Data< std::vector<T> > VecData;
 		typedef Data< std::vector<int> > VecIntData;
-		VecData* dataInput = dynamic_cast<VecData*>(list[0]);
-		VecData* dataOutput = dynamic_cast<VecData*>(list[1]);
-		VecIntData* dataIndices = dynamic_cast<VecIntData*>(list[2]);
+		VecData* dataInput = data_cast<VecData>(list[0]);
+		VecData* dataOutput = data_cast<VecData>(list[1]);
+		VecIntData* dataIndices = data_cast<VecIntData>(list[2]);
 
 		assert(dataInput && dataOutput && dataIndices);
 
@@ -116,9 +116,9 @@ public:
 		using IndVec = std::vector<IntVector>;
 		using ValData = Data<ValVec>;
 		using IndData =  Data<IndVec>;
-		ValData* dataInput = dynamic_cast<ValData*>(list[0]);
-		ValData* dataOutput = dynamic_cast<ValData*>(list[1]);
-		IndData* dataIndices = dynamic_cast<IndData*>(list[2]);
+		ValData* dataInput = data_cast<ValData>(list[0]);
+		ValData* dataOutput = data_cast<ValData>(list[1]);
+		IndData* dataIndices = data_cast<IndData>(list[2]);
 
 		assert(dataInput && dataOutput && dataIndices);
 
@@ -33,8 +33,8 @@ public:
 	void updateT(DataList& list)
 	{
 		typedef Data< std::vector<T> > VecData;
-		VecData* dataInput = dynamic_cast<VecData*>(list[0]);
-		VecData* dataOutput = dynamic_cast<VecData*>(list[1]);
+		VecData* dataInput = data_cast<VecData>(list[0]);
+		VecData* dataOutput = data_cast<VecData>(list[1]);
 		assert(dataInput && dataOutput);
 
 		const auto& input = dataInput->getValue();
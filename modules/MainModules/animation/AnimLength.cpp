@@ -44,9 +44,9 @@ public:
 		typedef Data< Animation<T> > AnimData;
 		typedef Data< float > RealData;
 		typedef Data< int > IntData;
-		AnimData* dataInput = dynamic_cast<AnimData*>(list[0]);
-		RealData* dataLength = dynamic_cast<RealData*>(list[1]);
-		IntData* dataSize = dynamic_cast<IntData*>(list[2]);
+		AnimData* dataInput = data_cast<AnimData>(list[0]);
+		RealData* dataLength = data_cast<RealData>(list[1]);
+		IntData* dataSize = data_cast<IntData>(list[2]);
 
 		assert(dataInput && dataLength && dataSize);
 
@@ -43,8 +43,8 @@ public:
 	{
 		typedef Data< std::vector<T> > VecData;
 		typedef Data< Animation<T> > AnimData;
-		AnimData* dataInput = dynamic_cast<AnimData*>(list[0]);
-		VecData* dataOutput = dynamic_cast<VecData*>(list[1]);
+		AnimData* dataInput = data_cast<AnimData>(list[0]);
+		VecData* dataOutput = data_cast<VecData>(list[1]);
 
 		assert(dataInput && dataOutput);
 
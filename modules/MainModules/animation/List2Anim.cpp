@@ -57,8 +57,8 @@ public:
 	{
 		typedef Data< std::vector<T> > VecData;
 		typedef Data< Animation<T> > AnimData;
-		VecData* dataInput = dynamic_cast<VecData*>(list[0]);
-		AnimData* dataOutput = dynamic_cast<AnimData*>(list[1]);
+		VecData* dataInput = data_cast<VecData>(list[0]);
+		AnimData* dataOutput = data_cast<AnimData>(list[1]);
 		assert(dataInput && dataOutput);
 
 		const std::vector<T>& inVal = dataInput->getValue();
@@ -122,9 +122,9 @@ public:
 		typedef Data< Animation<T> > AnimData;
 		typedef Data< std::vector<float> > KeysVecData;
 		typedef Data< std::vector<T> > ValuesVecData;
-		AnimData* dataInput = dynamic_cast<AnimData*>(list[0]);
-		KeysVecData* dataKeys = dynamic_cast<KeysVecData*>(list[1]);
-		ValuesVecData* dataValues = dynamic_cast<ValuesVecData*>(list[2]);
+		AnimData* dataInput = data_cast<AnimData>(list[0]);
+		KeysVecData* dataKeys = data_cast<KeysVecData>(list[1]);
+		ValuesVecData* dataValues = data_cast<ValuesVecData>(list[2]);
 		assert(dataInput && dataKeys && dataValues);
 
 		const auto& anim = dataInput->getValue();
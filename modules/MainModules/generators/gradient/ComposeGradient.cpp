@@ -48,8 +48,8 @@ public:
 	{
 		typedef Data< std::vector<Color> > VecColorData;
 		typedef Data< float > VecRealData;
-		VecColorData* dataColor = dynamic_cast<VecColorData*>(list[0]);
-		VecRealData* dataPosition = dynamic_cast<VecRealData*>(list[1]);
+		VecColorData* dataColor = data_cast<VecColorData>(list[0]);
+		VecRealData* dataPosition = data_cast<VecRealData>(list[1]);
 
 		assert(dataColor && dataPosition);
 
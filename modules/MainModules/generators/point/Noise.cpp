@@ -1,4 +1,5 @@
 #include <panda/object/ObjectFactory.h>
+#include <panda/helper/Parallel.h>
 #include <panda/helper/Perlin.h>
 #include <panda/helper/Random.h>
 
@@ -37,8 +38,10 @@ public:
 		int nb = valInput.size();
 		valOutput.resize(nb);
 
-		for(int i=0; i<nb; ++i)
-			valOutput[i] = perlin.fBm(valInput[i] * valScale);
+		helper::parallelFor(parentDocument(), nb, [&](int begin, int end) {
+			for(int i=begin; i<end; ++i)
+				valOutput[i] = perlin.fBm(valInput[i] * valScale);
+		}, 64);
 	}
 
 protected:
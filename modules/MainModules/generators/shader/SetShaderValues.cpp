@@ -57,8 +57,8 @@ public:
 	{
 		typedef Data< T > ValueData;
 		typedef Data< std::string > StringData;
-		ValueData* dataValue = dynamic_cast<ValueData*>(list[0]);
-		StringData* dataName = dynamic_cast<StringData*>(list[1]);
+		ValueData* dataValue = data_cast<ValueData>(list[0]);
+		StringData* dataName = data_cast<StringData>(list[1]);
 
 		assert(dataValue && dataName);
 
@@ -29,7 +29,7 @@ public:
 
 	void setDirtyValue(const DataNode* caller)
 	{
-		if(!m_dirtyValue)
+		if(!isDirty())
 		{
 			auto now = std::chrono::system_clock::now();
 			auto nowPlusDelta = now + std::chrono::milliseconds(delta.getValue());
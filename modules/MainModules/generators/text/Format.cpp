@@ -74,7 +74,7 @@ public:
 			return;
 
 		typedef Data< std::vector<T> > ValueData;
-		ValueData* dataInput = dynamic_cast<ValueData*>(list[0]);
+		ValueData* dataInput = data_cast<ValueData>(list[0]);
 		assert(dataInput);
 
 		const std::vector<T>& inVal = dataInput->getValue();
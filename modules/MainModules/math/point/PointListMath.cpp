@@ -1,4 +1,6 @@
 #include <panda/object/ObjectFactory.h>
+#include <panda/helper/Parallel.h>
+#include <panda/helper/Simd.h>
 #include <panda/types/Point.h>
 
 #include <cmath>
@@ -37,22 +39,27 @@ public:
 
 		if(nb)
 		{
-			Point sum;
-			for(const auto& pt : list)
-				sum += pt;
+			auto doc = parentDocument();
+			static_assert(sizeof(Point) == 2 * sizeof(float), "The SIMD kernels read the points as an array of floats");
+			const float* xy = &list[0].x;
+			Point sum = helper::parallelReduce(doc, nb, Point(), [xy](int begin, int end) {
+				Point partial;
+				helper::simd::sumPoints(xy + 2 * begin, end - begin, partial.x, partial.y);
+				return partial;
+			}, std::plus<Point>());
 
 			sum /= static_cast<float>(nb);
 
 			center.setValue(sum);
 
-			float E=0, E2=0;
-			for(int i=0; i<nb; ++i)
-			{
-				Point pt = list[i];
-				float d2 = (pt - sum).norm2();
-				E += sqrt(d2);
-				E2 += d2;
-			}
+			// Sums of the distances and of the squared distances
+			Point moments = helper::parallelReduce(doc, nb, Point(), [xy, sum](int begin, int end) {
+				Point partial;
+				helper::simd::distanceMoments(xy + 2 * begin, end - begin, sum.x, sum.y, partial.x, partial.y);
+				return partial;
+			}, std::plus<Point>());
+
+			float E = moments.x, E2 = moments.y;
 
 			E /= nb;
 			E2 /= nb;
@@ -1,4 +1,5 @@
 #include <panda/object/ObjectFactory.h>
+#include <panda/helper/Simd.h>
 
 #include <cmath>
 #include <algorithm>
@@ -38,24 +39,14 @@ public:
 
 		if(nb)
 		{
-			float tMin = list[0], tMax = list[0];
-			float E=0, E2=0;
-			for(int i=0; i<nb; ++i)
-			{
-				float v = list[i];
-				E += v;
-				E2 += v*v;
-				tMin = std::min(tMin, v);
-				tMax = std::max(tMax, v);
-			}
-
-			sum.setValue(E);
-			E /= nb;
-			E2 /= nb;
+			auto stats = helper::simd::statistics(list.data(), nb);
+			float E = stats.sum / nb, E2 = stats.sum2 / nb;
+
+			sum.setValue(stats.sum);
 			mean.setValue(E);
 			stdDev.setValue(sqrt(E2 - E*E));
-			vMin.setValue(tMin);
-			vMax.setValue(tMax);
+			vMin.setValue(stats.min);
+			vMax.setValue(stats.max);
 		}
 		else
 		{
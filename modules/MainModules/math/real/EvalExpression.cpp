@@ -129,8 +129,8 @@ public:
 	{
 		typedef Data< std::vector<T> > ListData;
 		typedef Data< std::string > StringData;
-		ListData* dataInput = dynamic_cast<ListData*>(list[0]);
-		StringData* dataName = dynamic_cast<StringData*>(list[1]);
+		ListData* dataInput = data_cast<ListData>(list[0]);
+		StringData* dataName = data_cast<StringData>(list[1]);
 		
 		assert(dataInput && dataName);
 
@@ -316,12 +316,11 @@ public:
 
 	void update()
 	{
-		const Mesh& input = m_input.getValue();
 		const std::vector<Point>& points = m_points.getValue();
+		m_output.takeValue(m_input); // Moving the mesh if we are the only one using it
 		auto output = m_output.getAccessor();
 
-		output.wref() = input;
-		int nb = std::min(input.nbPoints(), static_cast<int>(points.size()));
+		int nb = std::min(output->nbPoints(), static_cast<int>(points.size()));
 		for(int i=0; i<nb; ++i)
 			output.wref().getPoint(i) = points[i];
 	}
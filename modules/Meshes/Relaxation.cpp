@@ -1,8 +1,7 @@
 #include <panda/object/ObjectFactory.h>
+#include <panda/helper/Arena.h>
 #include <panda/types/Mesh.h>
 
-#include <set>
-
 namespace panda {
 
 using types::Point;
@@ -37,22 +36,24 @@ public:
 		if(!outMesh->hasEdgesAroundPoint())
 			outMesh->createEdgesAroundPointList();
 
-		std::set<int> borderSet;
+		int nbPts = outMesh->nbPoints();
+		helper::ArenaVector<char> onBorder(nbPts, 0);
 		if(fixBorder.getValue())
 		{
-			auto borderPts = outMesh->getPointsOnBorder();
-			borderSet.insert(borderPts.begin(), borderPts.end());
+			for(auto id : outMesh->getPointsOnBorder())
+				onBorder[id] = 1;
 		}
 
 		int nbIter = iterations.getValue();
-		int nbPts = outMesh->nbPoints();
 		float fact = factor.getValue();
+		helper::ArenaVector<Point> ptsCopy;
 		for(int i=0; i<nbIter; ++i)
 		{
-			auto ptsCopy = outMesh->getPoints();
+			const auto& points = outMesh->getPoints();
+			ptsCopy.assign(points.begin(), points.end());
 			for(int j=0; j<nbPts; ++j)
 			{
-				if(borderSet.find(j) != borderSet.end())
+				if(onBorder[j])
 					continue;
 
 				Point& pt = outMesh->getPoint(j);
@@ -39,6 +39,11 @@ void ParticleEngine::reset()
 	accelerations.getAccessor().clear();
 }
 
+std::size_t ParticleEngine::getInternalHeapSize() const
+{
+	return particles.capacity() * sizeof(Particle) + effectors.capacity() * sizeof(ParticleEffector*);
+}
+
 void ParticleEngine::updateEffectors()
 {
 	effectors.clear();
@@ -19,6 +19,7 @@ public:
 	virtual void reset();
 	virtual bool accepts(DockableObject* dockable) const;
 	virtual void update();
+	virtual std::size_t getInternalHeapSize() const;
 
 	void updateEffectors();
 
@@ -1,4 +1,5 @@
 #include <panda/helper/algorithm.h>
+#include <panda/helper/Arena.h>
 #include <panda/object/ObjectFactory.h>
 #include <panda/types/Path.h>
 
@@ -30,8 +31,6 @@ public:
 	{
 		const auto& input = m_input.getValue();
 		const auto& delta = m_delta.getValue();
-		auto output = m_output.getAccessor();
-		output.clear();
 
 		int nbA = input.size(), nbB = delta.size();
 		if(nbA && nbB)
@@ -39,11 +38,26 @@ public:
 			if(nbA < nbB && nbA > 1)		nbB = nbA;	// Either equal nb of A & B, or one of them is 1
 			else if(nbB < nbA && nbB > 1)	nbA = nbB;
 			int nb = std::max(nbA, nbB);
+
+			if(nb == nbA)
+			{ // Translate the paths in place (moving the input if we are the only one using it)
+				m_output.takeValue(m_input);
+				auto output = m_output.getAccessor();
+				output.resize(nb);
+				for(int i=0; i<nb; ++i)
+					output[i] += delta[i%nbB];
+				return;
+			}
+
+			auto output = m_output.getAccessor();
+			output.clear();
 			output.resize(nb);
 
 			for(int i=0; i<nb; ++i)
 				output[i] = input[i%nbA] + delta[i%nbB];
 		}
+		else
+			m_output.getAccessor().clear();
 	}
 
 protected:
@@ -256,10 +270,7 @@ public:
 
 			// Some precomputation
 			float totalLength = 0.0;
-			std::vector<float> lengths, starts, ends;
-			lengths.resize(nbPts - 1);
-			starts.resize(nbPts - 1);
-			ends.resize(nbPts - 1);
+			helper::ArenaVector<float> lengths(nbPts - 1), starts(nbPts - 1), ends(nbPts - 1);
 			Point pt1 = curve[0];
 			for(unsigned int i=0; i<nbPts-1; ++i)
 			{
@@ -276,7 +287,7 @@ public:
 			for(unsigned int i=0; i<nbAbscissa; ++i)
 			{
 				float a = helper::bound<float>(0.0, listAbscissa[i], totalLength - 1e-3f);
-				std::vector<float>::iterator iter = std::upper_bound(ends.begin(), ends.end(), a);
+				auto iter = std::upper_bound(ends.begin(), ends.end(), a);
 
 				unsigned int index = iter - ends.begin();
 				float p = 0.0;
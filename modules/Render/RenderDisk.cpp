@@ -9,6 +9,7 @@
 #include <panda/types/Gradient.h>
 #include <panda/types/Shader.h>
 #include <panda/helper/GradientCache.h>
+#include <panda/helper/Parallel.h>
 #include <panda/graphics/Buffer.h>
 #include <panda/graphics/ShaderProgram.h>
 #include <panda/graphics/VertexArrayObject.h>
@@ -87,6 +88,9 @@ public:
 			maxDist = std::max(0.001f, maxDist);
 
 			float PI2 = static_cast<float>(M_PI) * 2;
+
+			// First compute where the vertices of each disk go in the buffer
+			std::vector<int> discs; // Index of the center for each disk that will be drawn
 			for(int i=0; i<nbCenter; ++i)
 			{
 				float valRadius = listRadius[i % nbRadius];
@@ -95,28 +99,39 @@ public:
 				int nbSeg = static_cast<int>(PI2 / acosf(1.f - maxDist / valRadius));
 				if(nbSeg < 3) continue;
 
+				discs.push_back(i);
 				m_colorBuffer.push_back(listColor[i % nbColor]);
-
-				int nbVertices = m_vertexBuffer.size();
-				m_firstBuffer.push_back(nbVertices);
+				m_firstBuffer.push_back(m_firstBuffer.empty() ? 0 : m_firstBuffer.back() + m_countBuffer.back());
 				m_countBuffer.push_back(nbSeg + 2);
+			}
 
-				m_vertexBuffer.resize(nbVertices + nbSeg + 2);
-
-				const Point& valCenter = listCenter[i];
-				m_vertexBuffer[nbVertices] = valCenter;
-
-				float angle = PI2 / nbSeg;
-				float ca = cos(angle), sa = sin(angle);
-				Point dir = Point(valRadius, 0);
+			if(discs.empty())
+				return;
+			m_vertexBuffer.resize(m_firstBuffer.back() + m_countBuffer.back());
 
-				for(int i=0; i<=nbSeg; ++i)
+			// Then fill the vertices of the disks in parallel
+			helper::parallelFor(parentDocument(), discs.size(), [&](int begin, int end) {
+				for(int d=begin; d<end; ++d)
 				{
-					Point pt = Point(dir.x*ca+dir.y*sa, dir.y*ca-dir.x*sa);
-					m_vertexBuffer[nbVertices + 1 + i] = valCenter + pt;
-					dir = pt;
+					int nbVertices = m_firstBuffer[d], nbSeg = m_countBuffer[d] - 2;
+					int i = discs[d];
+					float valRadius = listRadius[i % nbRadius];
+
+					const Point& valCenter = listCenter[i];
+					m_vertexBuffer[nbVertices] = valCenter;
+
+					float angle = PI2 / nbSeg;
+					float ca = cos(angle), sa = sin(angle);
+					Point dir = Point(valRadius, 0);
+
+					for(int i=0; i<=nbSeg; ++i)
+					{
+						Point pt = Point(dir.x*ca+dir.y*sa, dir.y*ca-dir.x*sa);
+						m_vertexBuffer[nbVertices + 1 + i] = valCenter + pt;
+						dir = pt;
+					}
 				}
-			}
+			}, 16);
 		}
 	}
 
@@ -0,0 +1,59 @@
+#include <panda/data/Data.h>
+
+#include <cstdio>
+
+using panda::Data;
+
+// A Data linked to a parent of another type keeps its converted value until the parent is modified,
+// the counters of different Datas can be equal so relinking a Data upstream must also convert it again
+
+namespace
+{
+
+bool check(bool condition, const char* message)
+{
+	if (!condition)
+		std::printf("Failed: %s\n", message);
+	return condition;
+}
+
+bool testModifiedParent()
+{
+	Data<int> source("source", "", nullptr);
+	Data<float> converted("converted", "", nullptr);
+	source.setValue(1);
+	converted.setParent(&source);
+
+	bool ok = check(converted.getValue() == 1.f, "first conversion");
+	source.setValue(2);
+	ok &= check(converted.getValue() == 2.f, "conversion after a modification of the parent");
+	return ok;
+}
+
+bool testRelinkedIntermediate()
+{
+	Data<int> first("first", "", nullptr), second("second", "", nullptr);
+	first.setValue(1);
+	second.setValue(2); // Both have been modified once, their counters are equal
+
+	Data<int> intermediate("intermediate", "", nullptr); // Like the input of a group
+	Data<float> converted("converted", "", nullptr);
+	intermediate.setParent(&first);
+	converted.setParent(&intermediate);
+
+	bool ok = check(converted.getValue() == 1.f, "conversion through an intermediate Data");
+	ok &= check(first.getCounter() == second.getCounter(), "counters of the sources are equal");
+
+	intermediate.setParent(&second);
+	ok &= check(converted.getValue() == 2.f, "conversion after relinking the intermediate Data");
+	return ok;
+}
+
+} // namespace
+
+int main()
+{
+	bool ok = testModifiedParent();
+	ok &= testRelinkedIntermediate();
+	return ok ? 0 : 1;
+}
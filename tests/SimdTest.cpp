@@ -0,0 +1,90 @@
+#include <panda/helper/Simd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace simd = panda::helper::simd;
+
+// The AVX2 kernels must give exactly the same results as the scalar ones (same order of the additions)
+
+namespace
+{
+
+struct Results
+{
+	simd::Statistics stats;
+	float sumX = 0, sumY = 0, sumDist = 0, sumDist2 = 0;
+};
+
+Results compute(const std::vector<float>& values, const std::vector<float>& points, int count)
+{
+	Results results;
+	results.stats = simd::statistics(values.data(), count);
+	simd::sumPoints(points.data(), count, results.sumX, results.sumY);
+	simd::distanceMoments(points.data(), count, 0.5f, -1.5f, results.sumDist, results.sumDist2);
+	return results;
+}
+
+bool check(bool condition, const char* message, int count)
+{
+	if (!condition)
+		std::printf("Failed: %s (%d values)\n", message, count);
+	return condition;
+}
+
+bool testKernels(int count)
+{
+	std::vector<float> values(count), points(2 * count); // Points are interleaved, like in std::vector<Point>
+	for (int i = 0; i < count; ++i)
+	{
+		values[i] = std::sin(i * 0.37f) * 100;
+		points[2 * i] = std::cos(i * 0.11f) * 50;
+		points[2 * i + 1] = std::sin(i * 0.23f) * 20;
+	}
+
+	simd::setAVX2Enabled(false);
+	const Results scalar = compute(values, points, count);
+	simd::setAVX2Enabled(true);
+	const Results vector = compute(values, points, count);
+
+	// Reference values, computed in double precision
+	double sum = 0, sum2 = 0, sumX = 0, sumY = 0, sumDist = 0, sumDist2 = 0;
+	for (float v : values)
+	{
+		sum += v;
+		sum2 += v * v;
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		const double dx = points[2 * i] - 0.5, dy = points[2 * i + 1] + 1.5;
+		sumX += points[2 * i];
+		sumY += points[2 * i + 1];
+		sumDist += std::sqrt(dx * dx + dy * dy);
+		sumDist2 += dx * dx + dy * dy;
+	}
+
+	auto near = [](double value, double reference) { return std::abs(value - reference) <= 1e-3 * (1 + std::abs(reference)); };
+	bool ok = check(near(scalar.stats.sum, sum) && near(scalar.stats.sum2, sum2), "scalar statistics", count);
+	ok &= check(near(scalar.sumX, sumX) && near(scalar.sumY, sumY), "scalar sum of points", count);
+	ok &= check(near(scalar.sumDist, sumDist) && near(scalar.sumDist2, sumDist2), "scalar distance moments", count);
+
+	ok &= check(vector.stats.sum == scalar.stats.sum && vector.stats.sum2 == scalar.stats.sum2, "statistics sums", count);
+	ok &= check(vector.stats.min == scalar.stats.min && vector.stats.max == scalar.stats.max, "statistics bounds", count);
+	ok &= check(vector.sumX == scalar.sumX && vector.sumY == scalar.sumY, "sum of points", count);
+	ok &= check(vector.sumDist == scalar.sumDist && vector.sumDist2 == scalar.sumDist2, "distance moments", count);
+	return ok;
+}
+
+} // namespace
+
+int main()
+{
+	if (!simd::hasAVX2())
+		std::printf("No AVX2 on this CPU, only testing the scalar kernels\n");
+
+	bool ok = true;
+	for (int count : { 1, 7, 8, 9, 100, 1027 })
+		ok &= testKernels(count);
+	return ok ? 0 : 1;
+}
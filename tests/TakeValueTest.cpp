@@ -0,0 +1,124 @@
+#include <panda/SimpleGUI.h>
+#include <panda/TimedFunctions.h>
+#include <panda/document/ObjectsList.h>
+#include <panda/document/PandaDocument.h>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using panda::Data;
+using panda::PandaDocument;
+using panda::PandaObject;
+
+// A consumer takes the value of a producer during the multithreaded animation,
+// the producer must still propagate its modifications once the animation is stopped
+
+namespace
+{
+
+class TestGUI : public panda::gui::BaseGUI
+{
+public:
+	void updateView() override {}
+	void contextMakeCurrent() override {}
+	void contextDoneCurrent() override {}
+	void executeByUI(CallbackFunc func) override { m_functions.push_back(func); }
+	unsigned int getColor(panda::gui::Color) override { return 0; }
+
+	void clear() { m_functions.clear(); } // The steps are called directly by the test
+
+private:
+	std::vector<CallbackFunc> m_functions;
+};
+
+class Producer : public PandaObject
+{
+public:
+	Producer(PandaDocument* doc)
+		: PandaObject(doc)
+		, m_input(initData(0.f, "input", ""))
+		, m_output(initData("output", ""))
+	{
+		addInput(m_input);
+		addOutput(m_output);
+	}
+
+	void update() override
+	{ m_output.setValue(std::vector<float>(100, m_input.getValue())); }
+
+	Data<float> m_input;
+	Data<std::vector<float>> m_output;
+};
+
+class Consumer : public PandaObject
+{
+public:
+	Consumer(PandaDocument* doc)
+		: PandaObject(doc)
+		, m_input(initData("input", ""))
+		, m_output(initData("output", ""))
+	{
+		addInput(m_input);
+		addOutput(m_output);
+	}
+
+	void update() override
+	{
+		if (m_input.canTakeParentValue())
+			++m_nbTaken;
+		m_output.takeValue(m_input);
+	}
+
+	Data<std::vector<float>> m_input, m_output;
+	int m_nbTaken = 0;
+};
+
+bool check(bool condition, const char* message)
+{
+	if (!condition)
+		std::printf("Failed: %s\n", message);
+	return condition;
+}
+
+bool testTakeValueThenEdit()
+{
+	TestGUI gui;
+	PandaDocument document(gui);
+
+	auto producer = std::make_shared<Producer>(&document);
+	auto consumer = std::make_shared<Consumer>(&document);
+	document.getObjectsList().addObject(producer);
+	document.getObjectsList().addObject(consumer);
+	producer->m_input.setParent(document.getData("time"));
+	consumer->m_input.setParent(&producer->m_output);
+
+	panda::data_cast<Data<int>>(document.getData("nb threads"))->setValue(2);
+	document.play(true);
+	for (int i = 0; i < 5; ++i)
+	{
+		document.step();
+		gui.clear();
+	}
+	document.play(false);
+	gui.clear();
+
+	bool ok = check(consumer->m_nbTaken > 0, "the value was never taken");
+
+	// Edit the input of the producer, the consumer must be updated
+	producer->m_input.setParent(nullptr);
+	producer->m_input.setValue(42.f);
+	const auto& values = consumer->m_output.getValue();
+	ok &= check(values.size() == 100 && values.front() == 42.f, "the consumer was not updated after the animation");
+
+	return ok;
+}
+
+} // namespace
+
+int main()
+{
+	bool ok = testTakeValueThenEdit();
+	panda::TimedFunctions::shutdown();
+	return ok ? 0 : 1;
+}
@@ -12,6 +12,7 @@
 #include <ui/custom/ScrollContainer.h>
 
 #include <ui/dialog/EditGroupDialog.h>
+#include <ui/dialog/MemoryDialog.h>
 #include <ui/dialog/UpdateLoggerDialog.h>
 
 #include <ui/graphview/QtViewWrapper.h>
@@ -532,6 +533,11 @@ void MainWindow::createActions()
 	showLoggerDialogAction->setStatusTip(tr("Show the updates log dialog"));
 	connect(showLoggerDialogAction, &QAction::triggered, this, &MainWindow::showLoggerDialog);
 
+	auto showMemoryDialogAction = new QAction(tr("Show &memory"), this);
+	showMemoryDialogAction->setShortcut(tr("F3"));
+	showMemoryDialogAction->setStatusTip(tr("Show the memory used by each object and data"));
+	connect(showMemoryDialogAction, &QAction::triggered, this, &MainWindow::showMemoryDialog);
+
 	m_showDirtyInfoAction = new QAction(tr("Debug dirty state"), this);
 	m_showDirtyInfoAction->setCheckable(true);
 	m_showDirtyInfoAction->setStatusTip(tr("Show the dirty status of each object and data"));
@@ -749,6 +755,7 @@ void MainWindow::createActions()
 #ifdef PANDA_LOG_EVENTS
 	m_viewMenu->addAction(showLoggerDialogAction);
 #endif
+	m_viewMenu->addAction(showMemoryDialogAction);
 
 	menuBar()->addSeparator();
 
@@ -1302,7 +1309,9 @@ void MainWindow::showLoggerDialog()
 {
 	if(!m_loggerDialog)
 	{
+		panda::helper::UpdateLogger::getInstance()->setEnabled(true); // Start recording the events the first time the dialog is opened
 		m_loggerDialog = new UpdateLoggerDialog(this);
+		m_loggerDialog->setDocument(m_document);
 		UpdateLoggerDialog::setInstance(m_loggerDialog);
 
 		connect(m_loggerDialog, &UpdateLoggerDialog::changedSelectedEvent, [view = m_documentView] { view->update(); });
@@ -1317,6 +1326,23 @@ void MainWindow::showLoggerDialog()
 	}
 }
 
+void MainWindow::showMemoryDialog()
+{
+	if(!m_memoryDialog)
+	{
+		m_memoryDialog = new MemoryDialog(this);
+		m_memoryDialog->setDocument(m_document);
+	}
+
+	if(m_memoryDialog->isVisible())
+		m_memoryDialog->hide();
+	else
+	{
+		m_memoryDialog->show();
+		m_memoryDialog->updateUsage();
+	}
+}
+
 void MainWindow::showObjectsAndTypes()
 {
 	QString fileName = "file:///" + createObjectsAndTypesPage(m_document.get());
@@ -1701,6 +1727,10 @@ void MainWindow::setDocument(const std::shared_ptr<panda::PandaDocument>& docume
 	m_datasTable->setSelectedObject(m_document.get());
 
 	m_layersTab->setDocument(m_document);
+	if (m_memoryDialog)
+		m_memoryDialog->setDocument(m_document);
+	if (m_loggerDialog)
+		m_loggerDialog->setDocument(m_document);
 
 	for (auto action : m_allViewsActions)
 		m_documentView->addAction(action);
@@ -19,6 +19,7 @@ class DetachableWidgetInfo;
 class DetachedWindow;
 class ImageViewport;
 class LayersTab;
+class MemoryDialog;
 class OpenGLRenderView;
 class SimpleGUIImpl;
 class ScrollContainer;
@@ -70,6 +71,7 @@ private slots:
 	void createGroupObject();
 	void copyDataToUserValue();
 	void showLoggerDialog();
+	void showMemoryDialog();
 	void showObjectsAndTypes();
 	void play(bool);
 	void selectedObject(panda::PandaObject*);
@@ -125,6 +127,7 @@ private:
 	LayersTab* m_layersTab = nullptr;
 	QDockWidget* m_layersDock = nullptr;
 	UpdateLoggerDialog* m_loggerDialog = nullptr;
+	MemoryDialog* m_memoryDialog = nullptr;
 	SimpleGUIImpl* m_simpleGUI = nullptr;
 
 	QStringList m_recentFiles;
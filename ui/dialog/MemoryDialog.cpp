@@ -0,0 +1,196 @@
+#include <ui/dialog/MemoryDialog.h>
+
+#include <panda/data/BaseData.h>
+#include <panda/document/DocumentSignals.h>
+#include <panda/document/PandaDocument.h>
+
+#include <QtWidgets>
+
+#include <algorithm>
+#include <set>
+
+namespace
+{
+
+QString getReadableSize(long long size)
+{
+	auto absSize = std::abs(size);
+	if(absSize >= (1 << 30))
+		return QString("%1 GB").arg(QString::number(size / double(1 << 30), 'f', 2));
+	else if(absSize >= (1 << 20))
+		return QString("%1 MB").arg(QString::number(size / double(1 << 20), 'f', 2));
+	else if(absSize >= (1 << 10))
+		return QString("%1 KB").arg(QString::number(size / double(1 << 10), 'f', 2));
+	else
+		return QString("%1 B").arg(QString::number(size));
+}
+
+QString getGrowthText(std::size_t size, std::size_t previous)
+{
+	if(size == previous)
+		return QString();
+	const long long growth = static_cast<long long>(size) - static_cast<long long>(previous);
+	return (growth > 0 ? "+" : "") + getReadableSize(growth);
+}
+
+QString getObjectName(const panda::PandaObject* object)
+{
+	const auto name = QString::fromStdString(object->getName());
+	const auto label = QString::fromStdString(object->getLabel());
+	return label.isEmpty() ? name : QString("%1 (%2)").arg(label).arg(name);
+}
+
+}
+
+MemoryDialog::MemoryDialog(QWidget* parent)
+	: QDialog(parent)
+{
+	setWindowTitle(tr("Memory"));
+
+	m_tree = new QTreeWidget(this);
+	m_tree->setColumnCount(3);
+	m_tree->setHeaderLabels({ tr("Object / Data"), tr("Size"), tr("Growth") });
+	m_tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+	m_totalLabel = new QLabel(this);
+
+	m_trackingBox = new QCheckBox(tr("Record each step"), this);
+	m_trackingBox->setToolTip(tr("Keep the total memory used at the end of each step"));
+
+	QPushButton* updateButton = new QPushButton(tr("Update"));
+	QPushButton* okButton = new QPushButton(tr("Ok"));
+	QHBoxLayout* buttonsLayout = new QHBoxLayout;
+
+	buttonsLayout->addWidget(m_trackingBox);
+	buttonsLayout->addStretch();
+	buttonsLayout->addWidget(updateButton);
+	buttonsLayout->addWidget(okButton);
+
+	QVBoxLayout* mainLayout = new QVBoxLayout;
+	mainLayout->addWidget(m_tree);
+	mainLayout->addWidget(m_totalLabel);
+	mainLayout->addItem(buttonsLayout);
+
+	setLayout(mainLayout);
+	resize(500, 600);
+
+	connect(m_trackingBox, SIGNAL(toggled(bool)), this, SLOT(setTracking(bool)));
+	connect(updateButton, SIGNAL(clicked()), this, SLOT(updateUsage()));
+	connect(okButton, SIGNAL(clicked()), this, SLOT(hide()));
+}
+
+void MemoryDialog::setDocument(const std::shared_ptr<panda::PandaDocument>& document)
+{
+	m_document = document;
+	m_previousSizes.clear();
+	m_trackingBox->setChecked(document->memoryTracking());
+
+	m_observer.get(document->getSignals().timeChanged).connect<MemoryDialog, &MemoryDialog::timeChanged>(this);
+
+	if(isVisible())
+		updateUsage();
+}
+
+void MemoryDialog::timeChanged()
+{
+	if(isVisible())
+		updateUsage();
+}
+
+void MemoryDialog::updateUsage()
+{
+	auto document = m_document.lock();
+	if(!document)
+		return;
+
+	// Keep the expanded objects expanded after the tree is rebuilt
+	std::set<quintptr> expanded;
+	for(int i = 0, nb = m_tree->topLevelItemCount(); i < nb; ++i)
+	{
+		auto item = m_tree->topLevelItem(i);
+		if(item->isExpanded())
+			expanded.insert(item->data(0, Qt::UserRole).value<quintptr>());
+	}
+
+	auto usage = document->getMemoryUsage();
+	std::sort(usage.begin(), usage.end(), [](const panda::ObjectMemoryUsage& lhs, const panda::ObjectMemoryUsage& rhs) {
+		return lhs.totalSize > rhs.totalSize;
+	});
+
+	std::map<const void*, std::size_t> sizes;
+	auto previousSize = [this](const void* ptr, std::size_t size) {
+		auto it = m_previousSizes.find(ptr);
+		return it != m_previousSizes.end() ? it->second : size;
+	};
+
+	m_tree->clear();
+	std::size_t total = 0;
+	for(auto& objectUsage : usage)
+	{
+		const auto object = objectUsage.object;
+		total += objectUsage.totalSize;
+		sizes[object] = objectUsage.totalSize;
+
+		auto objectItem = new QTreeWidgetItem(m_tree);
+		objectItem->setText(0, getObjectName(object));
+		objectItem->setText(1, getReadableSize(objectUsage.totalSize));
+		objectItem->setText(2, getGrowthText(objectUsage.totalSize, previousSize(object, objectUsage.totalSize)));
+		objectItem->setData(0, Qt::UserRole, QVariant::fromValue(reinterpret_cast<quintptr>(object)));
+
+		if(objectUsage.internalSize)
+		{
+			auto internalItem = new QTreeWidgetItem(objectItem);
+			internalItem->setText(0, tr("(internal)"));
+			internalItem->setText(1, getReadableSize(objectUsage.internalSize));
+		}
+
+		std::sort(objectUsage.datas.begin(), objectUsage.datas.end(), [](const panda::DataMemoryUsage& lhs, const panda::DataMemoryUsage& rhs) {
+			return lhs.size > rhs.size;
+		});
+
+		for(const auto& dataUsage : objectUsage.datas)
+		{
+			const auto data = dataUsage.data;
+			const auto previous = previousSize(data, dataUsage.size);
+			sizes[data] = dataUsage.size;
+			if(!dataUsage.size && !previous)
+				continue;
+
+			auto dataItem = new QTreeWidgetItem(objectItem);
+			dataItem->setText(0, QString::fromStdString(data->getName()));
+			dataItem->setText(1, getReadableSize(dataUsage.size));
+			dataItem->setText(2, getGrowthText(dataUsage.size, previous));
+		}
+
+		if(expanded.count(reinterpret_cast<quintptr>(object)))
+			objectItem->setExpanded(true);
+	}
+
+	for(int i = 1; i < 3; ++i)
+		m_tree->resizeColumnToContents(i);
+
+	QString text = tr("Total: %1").arg(getReadableSize(total));
+	const auto& history = document->getMemoryHistory();
+	if(!history.empty())
+	{
+		const auto peak = std::max_element(history.begin(), history.end(), [](const panda::MemoryFrame& lhs, const panda::MemoryFrame& rhs) {
+			return lhs.totalSize < rhs.totalSize;
+		});
+		const long long growth = static_cast<long long>(history.back().totalSize) - static_cast<long long>(history.front().totalSize);
+		text += tr(", growth over %1 steps: %2, peak: %3 at time %4")
+			.arg(history.size())
+			.arg((growth > 0 ? "+" : "") + getReadableSize(growth))
+			.arg(getReadableSize(peak->totalSize))
+			.arg(peak->time);
+	}
+	m_totalLabel->setText(text);
+
+	m_previousSizes = std::move(sizes);
+}
+
+void MemoryDialog::setTracking(bool tracking)
+{
+	auto document = m_document.lock();
+	if(document && document->memoryTracking() != tracking)
+		document->setMemoryTracking(tracking);
+}
@@ -0,0 +1,45 @@
+#ifndef MEMORYDIALOG_H
+#define MEMORYDIALOG_H
+
+#include <panda/messaging.h>
+
+#include <QDialog>
+
+#include <map>
+#include <memory>
+
+class QCheckBox;
+class QLabel;
+class QTreeWidget;
+
+namespace panda
+{
+	class PandaDocument;
+}
+
+/// Memory used by each object and each Data of the document, refreshed after each step
+class MemoryDialog : public QDialog
+{
+	Q_OBJECT
+public:
+	explicit MemoryDialog(QWidget* parent = nullptr);
+	void setDocument(const std::shared_ptr<panda::PandaDocument>& document);
+
+protected:
+	void timeChanged();
+
+	QTreeWidget* m_tree;
+	QLabel* m_totalLabel;
+	QCheckBox* m_trackingBox;
+
+	std::weak_ptr<panda::PandaDocument> m_document;
+	std::map<const void*, std::size_t> m_previousSizes; // Sizes of the objects and Datas at the previous refresh, to show the growth
+
+	panda::msg::Observer m_observer;
+
+public slots:
+	void updateUsage();
+	void setTracking(bool tracking);
+};
+
+#endif // MEMORYDIALOG_H
@@ -1,6 +1,9 @@
 #include <ui/dialog/UpdateLoggerDialog.h>
 
+#include <panda/document/PandaDocument.h>
+#include <panda/document/Scheduler.h>
 #include <panda/helper/algorithm.h>
+#include <panda/helper/TraceExport.h>
 #include <vector>
 
 namespace
@@ -66,6 +69,8 @@ UpdateLoggerDialog::UpdateLoggerDialog(QWidget* parent) :
 	QPushButton* nextEventButton = new QPushButton("Next");
 	QPushButton* resetZoomButton = new QPushButton("Reset zoom");
 	QPushButton* updateButton = new QPushButton("Update");
+	QPushButton* exportButton = new QPushButton("Export...");
+	QPushButton* cutoffButton = new QPushButton("Early cutoff...");
 	QPushButton* okButton = new QPushButton("Ok");
 	QHBoxLayout* buttonsLayout = new QHBoxLayout;
 
@@ -74,13 +79,49 @@ UpdateLoggerDialog::UpdateLoggerDialog(QWidget* parent) :
 	buttonsLayout->addStretch();
 	buttonsLayout->addWidget(resetZoomButton);
 	buttonsLayout->addWidget(updateButton);
+	buttonsLayout->addWidget(exportButton);
+	buttonsLayout->addWidget(cutoffButton);
 	buttonsLayout->addWidget(okButton);
 
 	m_label = new QLabel(this);
 
+	// What is recorded during the next steps
+	using panda::helper::UpdateLogger;
+	auto logger = UpdateLogger::getInstance();
+	QCheckBox* recordCheckBox = new QCheckBox("Record the events");
+	recordCheckBox->setToolTip("Log the events of each step (this slows down the updates)");
+	recordCheckBox->setChecked(logger->isEnabled());
+	connect(recordCheckBox, &QCheckBox::toggled, [](bool checked) { UpdateLogger::getInstance()->setEnabled(checked); });
+
+	QHBoxLayout* recordLayout = new QHBoxLayout;
+	recordLayout->addWidget(recordCheckBox);
+	recordLayout->addStretch();
+
+	const std::pair<panda::helper::EventType, QString> eventTypes[] = {
+		{ panda::helper::event_update, "Updates" },
+		{ panda::helper::event_getValue, "GetValue" },
+		{ panda::helper::event_render, "Render" },
+		{ panda::helper::event_copyValue, "Copies" },
+		{ panda::helper::event_setDirty, "SetDirty" },
+		{ panda::helper::event_custom, "Others" }
+	};
+	for(const auto& eventType : eventTypes)
+	{
+		const unsigned int bit = panda::helper::eventBit(eventType.first);
+		QCheckBox* typeCheckBox = new QCheckBox(eventType.second);
+		typeCheckBox->setChecked((logger->getEventsMask() & bit) != 0);
+		connect(typeCheckBox, &QCheckBox::toggled, [bit](bool checked) {
+			auto logger = UpdateLogger::getInstance();
+			const auto mask = logger->getEventsMask();
+			logger->setEventsMask(checked ? mask | bit : mask & ~bit);
+		});
+		recordLayout->addWidget(typeCheckBox);
+	}
+
 	QVBoxLayout* mainLayout = new QVBoxLayout;
 	mainLayout->addWidget(m_view);
 	mainLayout->addWidget(m_label);
+	mainLayout->addItem(recordLayout);
 	mainLayout->addItem(buttonsLayout);
 
 	setLayout(mainLayout);
@@ -90,6 +131,8 @@ UpdateLoggerDialog::UpdateLoggerDialog(QWidget* parent) :
 	connect(nextEventButton, SIGNAL(clicked()), m_view, SLOT(nextEvent()));
 	connect(resetZoomButton, SIGNAL(clicked()), m_view, SLOT(resetZoom()));
 	connect(updateButton, SIGNAL(clicked()), m_view, SLOT(updateEvents()));
+	connect(exportButton, SIGNAL(clicked()), this, SLOT(exportTrace()));
+	connect(cutoffButton, SIGNAL(clicked()), this, SLOT(showCutoffStatistics()));
 	connect(okButton, SIGNAL(clicked()), this, SLOT(hide()));
 
 	connect(m_view, SIGNAL(changedSelectedEvent()), this, SIGNAL(changedSelectedEvent()));
@@ -103,11 +146,107 @@ void UpdateLoggerDialog::updateEvents()
 	emit changedSelectedEvent();
 }
 
+void UpdateLoggerDialog::setDocument(const std::shared_ptr<panda::PandaDocument>& document)
+{
+	m_document = document;
+}
+
 void UpdateLoggerDialog::setEventText(QString text)
 {
 	m_label->setText(text);
 }
 
+void UpdateLoggerDialog::exportTrace()
+{
+	bool ok = false;
+	int nbFrames = QInputDialog::getInt(this, "Export a trace", "Number of steps to record:", 10, 1, 10000, 1, &ok);
+	if(!ok)
+		return;
+
+	QString path = QFileDialog::getSaveFileName(this, "Export a trace", QString(), "Chrome trace (*.json)");
+	if(path.isEmpty())
+		return;
+
+	// The steps are recorded even if the "Record the events" check box is not checked
+	m_label->setText(QString("Recording the next %1 steps").arg(nbFrames));
+	std::string fileName = path.toStdString();
+	panda::helper::UpdateLogger::getInstance()->captureFrames(nbFrames, [this, fileName, path](const panda::helper::UpdateLogger::Frames& frames) {
+		if(panda::helper::writeChromeTrace(fileName, frames))
+			m_label->setText(QString("Trace saved in %1").arg(path));
+		else
+			m_label->setText(QString("Could not write %1").arg(path));
+	});
+}
+
+void UpdateLoggerDialog::showCutoffStatistics()
+{
+	auto document = m_document.lock();
+	auto scheduler = document ? document->getScheduler() : nullptr;
+	if(!scheduler || !scheduler->hasEarlyCutoff())
+	{
+		QMessageBox::information(this, "Early cutoff", "The early cutoff is not used. Check \"early cutoff\" in the properties of the document, and play the animation with multiple threads.");
+		return;
+	}
+
+	QDialog dialog(this);
+	dialog.setWindowTitle("Early cutoff");
+
+	QTreeWidget* tree = new QTreeWidget(&dialog);
+	tree->setColumnCount(4);
+	tree->setHeaderLabels({ "Object", "Updates", "Skipped", "Saved time" });
+	tree->setRootIsDecorated(false);
+	tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+	QLabel* totalLabel = new QLabel(&dialog);
+
+	auto fillTree = [tree, totalLabel, scheduler]() {
+		tree->clear();
+		double totalSaved = 0;
+		long long totalSkipped = 0;
+		for(const auto& stats : scheduler->cutoffStatistics()) // The objects that saved the most time first
+		{
+			const auto name = QString::fromStdString(stats.object->getName());
+			const auto label = QString::fromStdString(stats.object->getLabel());
+
+			auto item = new QTreeWidgetItem(tree);
+			item->setText(0, label.isEmpty() ? name : QString("%1 (%2)").arg(label).arg(name));
+			item->setText(1, QString::number(stats.nbUpdates));
+			item->setText(2, QString::number(stats.nbSkipped));
+			item->setText(3, getReadableTime(static_cast<long long>(stats.savedTime * 1e3)));
+			totalSaved += stats.savedTime;
+			totalSkipped += stats.nbSkipped;
+		}
+
+		for(int i = 1; i < 4; ++i)
+			tree->resizeColumnToContents(i);
+		totalLabel->setText(QString("%1 updates skipped, saving an estimated %2").arg(totalSkipped).arg(getReadableTime(static_cast<long long>(totalSaved * 1e3))));
+	};
+	fillTree();
+
+	QPushButton* resetButton = new QPushButton("Reset");
+	resetButton->setToolTip("Start counting again from the next step");
+	QPushButton* refreshButton = new QPushButton("Update");
+	QPushButton* okButton = new QPushButton("Ok");
+	QHBoxLayout* buttonsLayout = new QHBoxLayout;
+	buttonsLayout->addStretch();
+	buttonsLayout->addWidget(resetButton);
+	buttonsLayout->addWidget(refreshButton);
+	buttonsLayout->addWidget(okButton);
+
+	QVBoxLayout* mainLayout = new QVBoxLayout;
+	mainLayout->addWidget(tree);
+	mainLayout->addWidget(totalLabel);
+	mainLayout->addItem(buttonsLayout);
+	dialog.setLayout(mainLayout);
+	dialog.resize(500, 400);
+
+	connect(resetButton, &QPushButton::clicked, [scheduler, fillTree]() { scheduler->resetCutoffStatistics(); fillTree(); });
+	connect(refreshButton, &QPushButton::clicked, fillTree);
+	connect(okButton, &QPushButton::clicked, &dialog, &QDialog::accept);
+
+	dialog.exec();
+}
+
 UpdateLoggerDialog* UpdateLoggerDialog::getInstance()
 {
 	return m_instance;
@@ -552,7 +691,7 @@ void UpdateLoggerView::keyPressEvent(QKeyEvent* event)
 
 QString UpdateLoggerView::eventDescription(const EventData& event)
 {
-	auto text = QString::fromStdString(event.m_text);
+	auto text = QString::fromStdString(event.text());
 	switch (event.m_type)
 	{
 	case panda::helper::event_update:		return QString("Update of %1").arg(text);
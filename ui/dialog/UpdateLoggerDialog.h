@@ -6,6 +6,13 @@
 #include <QStylePainter>
 #include <QtWidgets>
 
+#include <memory>
+
+namespace panda
+{
+	class PandaDocument;
+}
+
 class UpdateLoggerView;
 
 class UpdateLoggerDialog : public QDialog
@@ -14,6 +21,7 @@ class UpdateLoggerDialog : public QDialog
 public:
 	explicit UpdateLoggerDialog(QWidget* parent = nullptr);
 	void updateEvents();
+	void setDocument(const std::shared_ptr<panda::PandaDocument>& document);
 
 	static UpdateLoggerDialog* getInstance();
 	static void setInstance(UpdateLoggerDialog* dlg);
@@ -24,6 +32,7 @@ public:
 protected:
 	UpdateLoggerView* m_view;
 	QLabel* m_label;
+	std::weak_ptr<panda::PandaDocument> m_document;
 	static UpdateLoggerDialog* m_instance;
 
 signals:
@@ -31,6 +40,8 @@ signals:
 
 public slots:
 	void setEventText(QString);
+	void exportTrace(); // Record the next steps and save them in the Chrome trace format
+	void showCutoffStatistics(); // Updates avoided by the early cutoff of the Scheduler
 };
 
 //****************************************************************************//
@@ -0,0 +1,590 @@
+// Headless benchmark: play a document for a number of steps and write the timings in JSON
+// Usage: panda-bench file.pnd [--frames N] [--warmup N] [--threads N] [--spin-time US] [--timestep S] [--output file.json] [--no-log] [--no-gl]
+
+#include <GL/glew.h>
+
+#ifdef WIN32
+#include <GLFW/glfw3.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <panda/PluginsManager.h>
+#include <panda/document/DocumentRenderer.h>
+#include <panda/document/ObjectsList.h>
+#include <panda/document/RenderedDocument.h>
+#include <panda/document/Scheduler.h>
+#include <panda/document/Serialization.h>
+#include <panda/helper/UpdateLogger.h>
+#include <panda/helper/system/FileRepository.h>
+#include <panda/object/PandaObject.h>
+
+#include "SimpleGUIImpl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+
+std::string getExecutablePath()
+{
+  char result[MAX_PATH];
+  return std::string(result, GetModuleFileName(NULL, result, MAX_PATH));
+}
+#else
+#include <string>
+#include <limits.h>
+#include <unistd.h>
+
+std::string getExecutablePath()
+{
+  char result[PATH_MAX];
+  auto count = readlink("/proc/self/exe", result, PATH_MAX);
+  return std::string(result, (count > 0) ? count : 0);
+}
+#endif
+
+namespace
+{
+
+struct Options
+{
+	std::string filePath, outputPath;
+	int nbFrames = 100, nbWarmupFrames = 10;
+	int nbThreads = 0, spinTime = 0;
+	float timestep = 0;
+	bool hasNbThreads = false, hasSpinTime = false; // Else keep the values saved in the document (same for the timestep if it is 0)
+	bool logObjects = true, useGL = true;
+};
+
+struct SchedulerStatistics // Read before stopping the animation, as the scheduler then releases its threads
+{
+	int nbThreads = 1;
+	panda::Scheduler::WakeUpStatistics wakeUps; // Of the measured steps only
+	bool earlyCutoff = false;
+	std::vector<panda::Scheduler::CutoffStatistics> cutoff; // Also of the measured steps, the objects that saved the most time first
+};
+
+struct ObjectStatistics
+{
+	long long nbUpdates = 0;
+	long long totalTime = 0, selfTime = 0; // In nanoseconds, the self time does not count the updates of other objects done during this one
+};
+
+bool parseArguments(int argc, char** argv, Options& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (arg == "--frames" && hasValue)
+			options.nbFrames = std::max(1, std::atoi(argv[++i]));
+		else if (arg == "--warmup" && hasValue)
+			options.nbWarmupFrames = std::max(0, std::atoi(argv[++i]));
+		else if (arg == "--threads" && hasValue)
+		{
+			options.nbThreads = std::atoi(argv[++i]);
+			options.hasNbThreads = true;
+		}
+		else if (arg == "--spin-time" && hasValue)
+		{
+			options.spinTime = std::atoi(argv[++i]);
+			options.hasSpinTime = true;
+		}
+		else if (arg == "--timestep" && hasValue)
+			options.timestep = static_cast<float>(std::atof(argv[++i]));
+		else if (arg == "--output" && hasValue)
+			options.outputPath = argv[++i];
+		else if (arg == "--no-log")
+			options.logObjects = false;
+		else if (arg == "--no-gl")
+			options.useGL = false;
+		else if (arg[0] != '-' && options.filePath.empty())
+			options.filePath = arg;
+		else
+			return false;
+	}
+
+	return !options.filePath.empty();
+}
+
+// OpenGL context not attached to any window, the documents render in framebuffer objects
+// Uses EGL, so that no display server is needed (on Windows, an invisible window is enough)
+class OffscreenContext
+{
+public:
+	~OffscreenContext() { destroy(); }
+
+	bool create();
+	void destroy();
+
+private:
+	bool createPlatformContext();
+
+#ifdef WIN32
+	GLFWwindow* m_window = nullptr;
+#else
+	EGLDisplay m_display = EGL_NO_DISPLAY;
+	EGLContext m_context = EGL_NO_CONTEXT;
+	EGLSurface m_surface = EGL_NO_SURFACE;
+#endif
+};
+
+bool OffscreenContext::create()
+{
+	if (!createPlatformContext())
+	{
+		destroy();
+		return false;
+	}
+
+	glewExperimental = GL_TRUE;
+	const GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	const bool glewValid = err == GLEW_OK || err == GLEW_ERROR_NO_GLX_DISPLAY; // GLEW built for GLX, the OpenGL functions are loaded nonetheless
+#else
+	const bool glewValid = err == GLEW_OK;
+#endif
+	if (!glewValid)
+	{
+		destroy();
+		return false;
+	}
+
+	return true;
+}
+
+#ifdef WIN32
+
+bool OffscreenContext::createPlatformContext()
+{
+	if (!glfwInit())
+		return false;
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+	m_window = glfwCreateWindow(64, 64, "Panda Bench", nullptr, nullptr);
+	if (!m_window)
+		return false;
+
+	glfwMakeContextCurrent(m_window);
+	return true;
+}
+
+void OffscreenContext::destroy()
+{
+	if (m_window)
+		glfwDestroyWindow(m_window);
+	m_window = nullptr;
+	glfwTerminate();
+}
+
+#else
+
+bool hasExtension(const char* extensions, const std::string& name)
+{
+	if (!extensions)
+		return false;
+	const std::string list = std::string(" ") + extensions + " ";
+	return list.find(" " + name + " ") != std::string::npos;
+}
+
+EGLDisplay initializeDisplay(EGLDisplay display)
+{
+	if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+		return display;
+	return EGL_NO_DISPLAY;
+}
+
+// The first GPU if the driver can access it directly, else Mesa without any window system, and lastly the default display
+EGLDisplay getHeadlessDisplay()
+{
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+	if (getPlatformDisplay)
+	{
+		auto queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+		EGLDeviceEXT device;
+		EGLint nbDevices = 0;
+		if (hasExtension(clientExtensions, "EGL_EXT_platform_device") && queryDevices && queryDevices(1, &device, &nbDevices) && nbDevices)
+		{
+			EGLDisplay display = initializeDisplay(getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, device, nullptr));
+			if (display != EGL_NO_DISPLAY)
+				return display;
+		}
+
+		if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+		{
+			EGLDisplay display = initializeDisplay(getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr));
+			if (display != EGL_NO_DISPLAY)
+				return display;
+		}
+	}
+
+	return initializeDisplay(eglGetDisplay(EGL_DEFAULT_DISPLAY));
+}
+
+bool OffscreenContext::createPlatformContext()
+{
+	m_display = getHeadlessDisplay();
+	if (m_display == EGL_NO_DISPLAY || !eglBindAPI(EGL_OPENGL_API))
+		return false;
+
+	// Without a surface if possible, else with a small pbuffer that is never used
+	const char* extensions = eglQueryString(m_display, EGL_EXTENSIONS);
+	const bool surfaceless = hasExtension(extensions, "EGL_KHR_surfaceless_context");
+	const EGLint configAttribs[] = {
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+		EGL_NONE
+	};
+
+	EGLConfig config = nullptr;
+	EGLint nbConfigs = 0;
+	if (!eglChooseConfig(m_display, configAttribs, &config, 1, &nbConfigs) || !nbConfigs)
+	{
+#ifdef EGL_KHR_no_config_context
+		if (!surfaceless || !hasExtension(extensions, "EGL_KHR_no_config_context")) // Some devices do not expose any config
+			return false;
+		config = EGL_NO_CONFIG_KHR;
+#else
+		return false;
+#endif
+	}
+
+	const EGLint contextAttribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+		EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+		EGL_NONE
+	};
+	m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttribs);
+	if (m_context == EGL_NO_CONTEXT)
+		return false;
+
+	if (!surfaceless)
+	{
+		const EGLint surfaceAttribs[] = { EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE };
+		m_surface = eglCreatePbufferSurface(m_display, config, surfaceAttribs);
+		if (m_surface == EGL_NO_SURFACE)
+			return false;
+	}
+
+	return eglMakeCurrent(m_display, m_surface, m_surface, m_context) == EGL_TRUE;
+}
+
+void OffscreenContext::destroy()
+{
+	if (m_display == EGL_NO_DISPLAY)
+		return;
+
+	eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (m_surface != EGL_NO_SURFACE)
+		eglDestroySurface(m_display, m_surface);
+	if (m_context != EGL_NO_CONTEXT)
+		eglDestroyContext(m_display, m_context);
+	eglTerminate(m_display);
+
+	m_display = EGL_NO_DISPLAY;
+	m_context = EGL_NO_CONTEXT;
+	m_surface = EGL_NO_SURFACE;
+}
+
+#endif
+
+void setIntData(panda::PandaObject* object, const std::string& name, int value)
+{
+	if (auto data = panda::data_cast<panda::Data<int>>(object->getData(name)))
+		data->setValue(value);
+}
+
+void setFloatData(panda::PandaObject* object, const std::string& name, float value)
+{
+	if (auto data = panda::data_cast<panda::Data<float>>(object->getData(name)))
+		data->setValue(value);
+}
+
+// Mean update time of each object, from the update events of the captured frames
+std::map<int, ObjectStatistics> computeObjectStatistics(const panda::helper::UpdateLogger::Frames& frames)
+{
+	using panda::helper::EventData;
+	std::map<int, ObjectStatistics> statistics;
+	for (const auto& frame : frames)
+	{
+		for (auto events : frame)
+		{
+			// The updates of an object can contain the updates of its inputs (when not using the scheduler)
+			std::sort(events.begin(), events.end(), [](const EventData& lhs, const EventData& rhs) {
+				return lhs.m_startTime < rhs.m_startTime || (lhs.m_startTime == rhs.m_startTime && lhs.m_endTime > rhs.m_endTime);
+			});
+
+			std::vector<const EventData*> stack;
+			for (const auto& event : events)
+			{
+				if (event.m_type != panda::helper::event_update || event.m_objectIndex < 0)
+					continue;
+
+				while (!stack.empty() && stack.back()->m_endTime <= event.m_startTime)
+					stack.pop_back();
+
+				const long long duration = event.m_endTime - event.m_startTime;
+				if (!stack.empty())
+					statistics[stack.back()->m_objectIndex].selfTime -= duration;
+
+				auto& stats = statistics[event.m_objectIndex];
+				++stats.nbUpdates;
+				stats.totalTime += duration;
+				stats.selfTime += duration;
+				stack.push_back(&event);
+			}
+		}
+	}
+	return statistics;
+}
+
+double percentile(const std::vector<double>& sortedValues, double p)
+{
+	if (sortedValues.empty())
+		return 0;
+	const auto rank = static_cast<std::size_t>(std::ceil(p / 100 * sortedValues.size()));
+	return sortedValues[std::min(sortedValues.size() - 1, rank ? rank - 1 : 0)];
+}
+
+std::string jsonString(const std::string& text)
+{
+	std::string result = "\"";
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+			result += '\\';
+		if (static_cast<unsigned char>(c) < 0x20)
+			result += ' ';
+		else
+			result += c;
+	}
+	return result + "\"";
+}
+
+SchedulerStatistics getSchedulerStatistics(const panda::PandaDocument& document)
+{
+	SchedulerStatistics statistics;
+	auto scheduler = document.getScheduler();
+	if (!scheduler || !document.animationIsMultithread())
+		return statistics; // Updated by the main thread only
+
+	statistics.nbThreads = scheduler->nbThreads();
+	statistics.wakeUps = scheduler->wakeUpStatistics();
+	statistics.earlyCutoff = scheduler->hasEarlyCutoff();
+	if (statistics.earlyCutoff)
+		statistics.cutoff = scheduler->cutoffStatistics();
+	return statistics;
+}
+
+void writeReport(std::ostream& out, const Options& options, const panda::PandaDocument& document, std::vector<double> frameTimes,
+				 const SchedulerStatistics& schedulerStatistics, const std::map<int, ObjectStatistics>& objectStatistics)
+{
+	std::sort(frameTimes.begin(), frameTimes.end());
+	double total = 0;
+	for (double time : frameTimes)
+		total += time;
+
+	out << "{\n";
+	out << "  \"file\": " << jsonString(options.filePath) << ",\n";
+	out << "  \"frames\": " << frameTimes.size() << ",\n";
+	out << "  \"warmup_frames\": " << options.nbWarmupFrames << ",\n";
+	out << "  \"threads\": " << schedulerStatistics.nbThreads << ",\n";
+	const auto& wakeUps = schedulerStatistics.wakeUps;
+	out << "  \"wake_ups\": {";
+	out << " \"count\": " << wakeUps.nbWakeUps;
+	out << ", \"blocked\": " << wakeUps.nbBlocked;
+	out << ", \"mean_latency_us\": " << wakeUps.meanLatency;
+	out << ", \"max_latency_us\": " << wakeUps.maxLatency << " },\n";
+	out << "  \"timestep\": " << document.getTimeStep() << ",\n";
+	out << "  \"frame_time_ms\": {";
+	out << " \"mean\": " << (frameTimes.empty() ? 0 : total / frameTimes.size());
+	out << ", \"min\": " << (frameTimes.empty() ? 0 : frameTimes.front());
+	out << ", \"p50\": " << percentile(frameTimes, 50);
+	out << ", \"p90\": " << percentile(frameTimes, 90);
+	out << ", \"p99\": " << percentile(frameTimes, 99);
+	out << ", \"max\": " << (frameTimes.empty() ? 0 : frameTimes.back()) << " },\n";
+
+	// The most expensive objects first
+	std::vector<std::pair<int, ObjectStatistics>> objects(objectStatistics.begin(), objectStatistics.end());
+	std::sort(objects.begin(), objects.end(), [](const std::pair<int, ObjectStatistics>& lhs, const std::pair<int, ObjectStatistics>& rhs) {
+		return lhs.second.selfTime > rhs.second.selfTime;
+	});
+
+	out << "  \"objects\": [";
+	for (std::size_t i = 0; i < objects.size(); ++i)
+	{
+		const auto& stats = objects[i].second;
+		const auto object = document.getObjectsList().find(objects[i].first);
+		const std::string name = object ? object->getName() : "object " + std::to_string(objects[i].first);
+		out << (i ? ",\n" : "\n") << "    { \"index\": " << objects[i].first
+			<< ", \"name\": " << jsonString(name)
+			<< ", \"updates\": " << stats.nbUpdates
+			<< ", \"mean_update_us\": " << stats.totalTime / 1e3 / stats.nbUpdates
+			<< ", \"mean_self_us\": " << stats.selfTime / 1e3 / stats.nbUpdates << " }";
+	}
+	out << (objects.empty() ? "],\n" : "\n  ],\n");
+
+	// Objects whose update was avoided by the early cutoff, as their inputs did not change
+	double totalSaved = 0;
+	long long totalSkipped = 0;
+	for (const auto& stats : schedulerStatistics.cutoff)
+	{
+		totalSaved += stats.savedTime;
+		totalSkipped += stats.nbSkipped;
+	}
+
+	out << "  \"early_cutoff\": {";
+	out << " \"enabled\": " << (schedulerStatistics.earlyCutoff ? "true" : "false");
+	out << ", \"skipped\": " << totalSkipped;
+	out << ", \"saved_us\": " << totalSaved;
+	out << ", \"objects\": [";
+	bool first = true;
+	for (const auto& stats : schedulerStatistics.cutoff)
+	{
+		if (!stats.nbSkipped)
+			continue;
+		out << (first ? "\n" : ",\n") << "    { \"index\": " << stats.object->getIndex()
+			<< ", \"name\": " << jsonString(stats.object->getName())
+			<< ", \"updates\": " << stats.nbUpdates
+			<< ", \"skipped\": " << stats.nbSkipped
+			<< ", \"saved_us\": " << stats.savedTime << " }";
+		first = false;
+	}
+	out << (first ? "] }\n" : "\n  ] }\n");
+	out << "}\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseArguments(argc, argv, options))
+	{
+		std::cerr << "Usage: panda-bench file.pnd [--frames N] [--warmup N] [--threads N] [--spin-time US] [--timestep S] [--output file.json] [--no-log] [--no-gl]" << std::endl;
+		return 1;
+	}
+
+	OffscreenContext context;
+	const bool hasContext = options.useGL && context.create();
+	if (options.useGL && !hasContext)
+		std::cerr << "Could not create an OpenGL context, only the documents without rendering can be used" << std::endl;
+
+	auto& dataRepository = panda::helper::system::DataRepository;
+	dataRepository.addPath(boost::filesystem::current_path().string());
+	boost::filesystem::path exePath = getExecutablePath();
+	dataRepository.addPath(exePath.parent_path().string());
+	dataRepository.addPath(boost::filesystem::path(options.filePath).parent_path().string());
+
+	panda::PluginsManager::loadPlugins();
+
+	SimpleGUIImpl gui;
+	std::shared_ptr<panda::PandaDocument> document = panda::serialization::readFile(options.filePath, gui);
+	if (!document)
+	{
+		std::cerr << "Could not load " << options.filePath << std::endl;
+		return 1;
+	}
+
+	auto renderedDocument = dynamic_cast<panda::RenderedDocument*>(document.get());
+	if (renderedDocument && !hasContext)
+	{
+		std::cerr << options.filePath << " renders images and needs an OpenGL context" << std::endl;
+		return 1;
+	}
+
+	if (renderedDocument)
+	{
+		auto& renderer = renderedDocument->getRenderer();
+		renderer.initializeGL();
+		renderer.setRenderingMainView(true);
+	}
+
+	if (options.hasNbThreads)
+		setIntData(document.get(), "nb threads", options.nbThreads);
+	if (options.hasSpinTime)
+		setIntData(document.get(), "threads spin time", options.spinTime);
+	if (options.timestep > 0)
+		setFloatData(document.get(), "timestep", options.timestep);
+	setIntData(document.get(), "use timer", 0); // Compute the next step as soon as the previous one is finished
+
+	// Only the updates are logged, and only during the measured steps
+	auto logger = panda::helper::UpdateLogger::getInstance();
+	logger->setEnabled(false);
+	logger->setEventsMask(panda::helper::eventBit(panda::helper::event_update));
+	panda::helper::UpdateLogger::Frames capturedFrames;
+
+	std::vector<double> frameTimes;
+	frameTimes.reserve(options.nbFrames);
+	const int nbSteps = options.nbWarmupFrames + options.nbFrames;
+	int step = 0;
+	bool measuring = false;
+
+	document->play(true); // Each step asks the GUI for the execution of the next one
+	while (step < nbSteps)
+	{
+		if (step == options.nbWarmupFrames && !measuring)
+		{
+			measuring = true;
+			if (auto scheduler = document->getScheduler())
+			{
+				scheduler->resetWakeUpStatistics();
+				scheduler->resetCutoffStatistics();
+			}
+		}
+
+		if (step == options.nbWarmupFrames && options.logObjects && !logger->isCapturing())
+			logger->captureFrames(options.nbFrames, [&capturedFrames](const panda::helper::UpdateLogger::Frames& frames) { capturedFrames = frames; });
+
+		const float animTime = document->getAnimationTime();
+		const auto start = std::chrono::high_resolution_clock::now();
+		gui.executeFunctions();
+		if (renderedDocument)
+			glFinish(); // Include the time taken by the GPU
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		if (document->getAnimationTime() == animTime)
+			continue; // No step was done by these functions
+
+		if (step >= options.nbWarmupFrames)
+			frameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		++step;
+	}
+	const auto schedulerStatistics = getSchedulerStatistics(*document);
+	document->play(false);
+	gui.executeFunctions();
+
+	const auto objectStatistics = computeObjectStatistics(capturedFrames);
+	if (options.outputPath.empty())
+		writeReport(std::cout, options, *document, frameTimes, schedulerStatistics, objectStatistics);
+	else
+	{
+		std::ofstream out(options.outputPath);
+		if (!out)
+		{
+			std::cerr << "Could not write " << options.outputPath << std::endl;
+			return 1;
+		}
+		writeReport(out, options, *document, frameTimes, schedulerStatistics, objectStatistics);
+	}
+
+	document.reset(); // Before the destruction of the context
+	return 0;
+}